@@ -43,6 +43,20 @@ class Het_meshs(SimpleTopology):
 
     print "Creating Topology: " + description
 
+    # Chiplet layout. Row 0 of a mesh is its South edge, column 0 its
+    # West edge. Each chiplet links one edge ("South" or "North") to a
+    # side of the interposer, one link per chiplet column, starting
+    # 'offset' routers along that side (from its West or South end),
+    # in reverse column order if 'reverse'. --num-cpus must match.
+    chiplet_rows = 4
+    chiplet_cols = 4
+    interposer_rows = 4
+    interposer_cols = 4
+    # (interposer side, chiplet edge, offset, reverse) per chiplet
+    chiplets = [("West", "South", 0, False),
+                ("East", "South", 0, True),
+                ("South", "North", 0, False)]
+
     def __init__(self, controllers):
         self.nodes = controllers
 
@@ -110,535 +124,174 @@ class Het_meshs(SimpleTopology):
 
         # Create the mesh links.
         int_links = []
-        
-        ###### for chiplet1 (16 nodes): 0 - 15 nodes
-        print("Creating Chiplet 1 (16 nodes): nodes 0 to 15")
-        # East output to West input links (weight = 1)
-        num_rows = 4
-        num_columns = 4
-        for row in xrange(num_rows):
-            for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_out = col + (row * num_columns)
-                    west_in = (col + 1) + (row * num_columns)
-                    print "Router " + get_id(routers[east_out]) + " created a link to Router " +  get_id(routers[west_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[east_out],
-                                             dst_node=routers[west_in],
-                                             src_outport="East",
-                                             dst_inport="West",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # West output to East input links (weight = 1)
-        for row in xrange(num_rows):
-            for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_in = col + (row * num_columns)
-                    west_out = (col + 1) + (row * num_columns)
-                    print "Router " + get_id(routers[west_out]) + " created a link to Router " +  get_id(routers[east_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[west_out],
-                                             dst_node=routers[east_in],
-                                             src_outport="West",
-                                             dst_inport="East",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # North output to South input links (weight = 2)
-        for col in xrange(num_columns):
-            for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_out = col + (row * num_columns)
-                    south_in = col + ((row + 1) * num_columns)
-                    print "Router " + get_id(routers[north_out]) + " created a link to Router " +  get_id(routers[south_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[north_out],
-                                             dst_node=routers[south_in],
-                                             src_outport="North",
-                                             dst_inport="South",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # South output to North input links (weight = 2)
-        for col in xrange(num_columns):
-            for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_in = col + (row * num_columns)
-                    south_out = col + ((row + 1) * num_columns)
-                    print "Router " + get_id(routers[south_out]) + " created a link to Router " +  get_id(routers[north_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[south_out],
-                                             dst_node=routers[north_in],
-                                             src_outport="South",
-                                             dst_inport="North",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-        ##### end of chiplet 1
-
-
-        ###### for chiplet2 (16 nodes): 16 - 31 nodes
-        print("Creating Chiplet 2 (16 nodes): nodes 16 to 31")
-        # East output to West input links (weight = 1)
-        num_rows = 4
-        num_columns = 4
-        for row in xrange(num_rows):
-            for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_out = col + (row * num_columns) + 16
-                    west_in = (col + 1) + (row * num_columns) + 16
-                    print "Router " + get_id(routers[east_out]) + " created a link to Router " +  get_id(routers[west_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[east_out],
-                                             dst_node=routers[west_in],
-                                             src_outport="East",
-                                             dst_inport="West",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # West output to East input links (weight = 1)
-        for row in xrange(num_rows):
-            for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_in = col + (row * num_columns) + 16
-                    west_out = (col + 1) + (row * num_columns) + 16
-                    print "Router " + get_id(routers[west_out]) + " created a link to Router " +  get_id(routers[east_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[west_out],
-                                             dst_node=routers[east_in],
-                                             src_outport="West",
-                                             dst_inport="East",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # North output to South input links (weight = 2)
-        for col in xrange(num_columns):
-            for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_out = col + (row * num_columns) + 16
-                    south_in = col + ((row + 1) * num_columns) + 16
-                    print "Router " + get_id(routers[north_out]) + " created a link to Router " +  get_id(routers[south_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[north_out],
-                                             dst_node=routers[south_in],
-                                             src_outport="North",
-                                             dst_inport="South",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # South output to North input links (weight = 2)
-        for col in xrange(num_columns):
-            for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_in = col + (row * num_columns) + 16
-                    south_out = col + ((row + 1) * num_columns) + 16
-                    print "Router " + get_id(routers[south_out]) + " created a link to Router " +  get_id(routers[north_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[south_out],
-                                             dst_node=routers[north_in],
-                                             src_outport="South",
-                                             dst_inport="North",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-        ##### end of chiplet 2
-
-
-        ###### for chiplet3 (16 nodes): 32 - 47 nodes
-        print("Creating Chiplet 3 (4 nodes): nodes 32 to 47")
-        # East output to West input links (weight = 1)
-        num_rows = 4
-        num_columns = 4
-        for row in xrange(num_rows):
-            for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_out = col + (row * num_columns) + 32
-                    west_in = (col + 1) + (row * num_columns) + 32
-                    print "Router " + get_id(routers[east_out]) + " created a link to Router " +  get_id(routers[west_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[east_out],
-                                             dst_node=routers[west_in],
-                                             src_outport="East",
-                                             dst_inport="West",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # West output to East input links (weight = 1)
-        for row in xrange(num_rows):
-            for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_in = col + (row * num_columns) + 32
-                    west_out = (col + 1) + (row * num_columns) + 32
-                    print "Router " + get_id(routers[west_out]) + " created a link to Router " +  get_id(routers[east_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[west_out],
-                                             dst_node=routers[east_in],
-                                             src_outport="West",
-                                             dst_inport="East",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # North output to South input links (weight = 2)
-        for col in xrange(num_columns):
+
+        # Regions: the chiplets, then the interposer, each a mesh of
+        # consecutive router ids
+        chiplet_size = self.chiplet_rows * self.chiplet_cols
+        interposer_region = len(self.chiplets)
+        interposer_base = interposer_region * chiplet_size
+        assert(num_routers == interposer_base +
+               self.interposer_rows * self.interposer_cols)
+        regions = [(c * chiplet_size, self.chiplet_rows, self.chiplet_cols)
+                   for c in xrange(len(self.chiplets))]
+        regions.append((interposer_base, self.interposer_rows,
+                        self.interposer_cols))
+
+        for (region, (base, num_rows, num_columns)) in enumerate(regions):
+            if region == interposer_region:
+                print("Creating Interposer (%d nodes): nodes %d to %d" \
+                      % (num_rows * num_columns, base,
+                         base + num_rows * num_columns - 1))
+            else:
+                print("Creating Chiplet %d (%d nodes): nodes %d to %d" \
+                      % (region + 1, num_rows * num_columns, base,
+                         base + num_rows * num_columns - 1))
+
+            # East output to West input links (weight = 1)
             for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_out = col + (row * num_columns) + 32
-                    south_in = col + ((row + 1) * num_columns) + 32
-                    print "Router " + get_id(routers[north_out]) + " created a link to Router " +  get_id(routers[south_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[north_out],
-                                             dst_node=routers[south_in],
-                                             src_outport="North",
-                                             dst_inport="South",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # South output to North input links (weight = 2)
-        for col in xrange(num_columns):
+                for col in xrange(num_columns):
+                    if (col + 1 < num_columns):
+                        east_out = col + (row * num_columns) + base
+                        west_in = (col + 1) + (row * num_columns) + base
+                        print "Router " + get_id(routers[east_out]) + " created a link to Router " +  get_id(routers[west_in])
+                        int_links.append(IntLink(link_id=link_count,
+                                                 src_node=routers[east_out],
+                                                 dst_node=routers[west_in],
+                                                 src_outport="East",
+                                                 dst_inport="West",
+                                                 latency = link_latency,
+                                                 weight=1))
+                        link_count += 1
+
+            # West output to East input links (weight = 1)
             for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_in = col + (row * num_columns) + 32
-                    south_out = col + ((row + 1) * num_columns) + 32
-                    print "Router " + get_id(routers[south_out]) + " created a link to Router " +  get_id(routers[north_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[south_out],
-                                             dst_node=routers[north_in],
-                                             src_outport="South",
-                                             dst_inport="North",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-        ##### end of chiplet 3
-        
-        ###### for Interposer (16 nodes): 48 - 63 nodes
-        print("Creating Chiplet 3 (4 nodes): nodes 48 to 63")
-        # East output to West input links (weight = 1)
-        num_rows = 4
-        num_columns = 4
-        for row in xrange(num_rows):
+                for col in xrange(num_columns):
+                    if (col + 1 < num_columns):
+                        east_in = col + (row * num_columns) + base
+                        west_out = (col + 1) + (row * num_columns) + base
+                        print "Router " + get_id(routers[west_out]) + " created a link to Router " +  get_id(routers[east_in])
+                        int_links.append(IntLink(link_id=link_count,
+                                                 src_node=routers[west_out],
+                                                 dst_node=routers[east_in],
+                                                 src_outport="West",
+                                                 dst_inport="East",
+                                                 latency = link_latency,
+                                                 weight=1))
+                        link_count += 1
+
+            # North output to South input links (weight = 2)
             for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_out = col + (row * num_columns) + 48
-                    west_in = (col + 1) + (row * num_columns) + 48
-                    print "Router " + get_id(routers[east_out]) + " created a link to Router " +  get_id(routers[west_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[east_out],
-                                             dst_node=routers[west_in],
-                                             src_outport="East",
-                                             dst_inport="West",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # West output to East input links (weight = 1)
-        for row in xrange(num_rows):
+                for row in xrange(num_rows):
+                    if (row + 1 < num_rows):
+                        north_out = col + (row * num_columns) + base
+                        south_in = col + ((row + 1) * num_columns) + base
+                        print "Router " + get_id(routers[north_out]) + " created a link to Router " +  get_id(routers[south_in])
+                        int_links.append(IntLink(link_id=link_count,
+                                                 src_node=routers[north_out],
+                                                 dst_node=routers[south_in],
+                                                 src_outport="North",
+                                                 dst_inport="South",
+                                                 latency = link_latency,
+                                                 weight=1))
+                        link_count += 1
+
+            # South output to North input links (weight = 2)
             for col in xrange(num_columns):
-                if (col + 1 < num_columns):
-                    east_in = col + (row * num_columns) + 48
-                    west_out = (col + 1) + (row * num_columns) + 48
-                    print "Router " + get_id(routers[west_out]) + " created a link to Router " +  get_id(routers[east_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[west_out],
-                                             dst_node=routers[east_in],
-                                             src_outport="West",
-                                             dst_inport="East",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # North output to South input links (weight = 2)
-        for col in xrange(num_columns):
-            for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_out = col + (row * num_columns) + 48
-                    south_in = col + ((row + 1) * num_columns) + 48
-                    print "Router " + get_id(routers[north_out]) + " created a link to Router " +  get_id(routers[south_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[north_out],
-                                             dst_node=routers[south_in],
-                                             src_outport="North",
-                                             dst_inport="South",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-
-        # South output to North input links (weight = 2)
-        for col in xrange(num_columns):
-            for row in xrange(num_rows):
-                if (row + 1 < num_rows):
-                    north_in = col + (row * num_columns) + 48
-                    south_out = col + ((row + 1) * num_columns) + 48
-                    print "Router " + get_id(routers[south_out]) + " created a link to Router " +  get_id(routers[north_in])
-                    int_links.append(IntLink(link_id=link_count,
-                                             src_node=routers[south_out],
-                                             dst_node=routers[north_in],
-                                             src_outport="South",
-                                             dst_inport="North",
-                                             latency = link_latency,
-                                             weight=1))
-                    link_count += 1
-        ##### end of Interposer
+                for row in xrange(num_rows):
+                    if (row + 1 < num_rows):
+                        north_in = col + (row * num_columns) + base
+                        south_out = col + ((row + 1) * num_columns) + base
+                        print "Router " + get_id(routers[south_out]) + " created a link to Router " +  get_id(routers[north_in])
+                        int_links.append(IntLink(link_id=link_count,
+                                                 src_node=routers[south_out],
+                                                 dst_node=routers[north_in],
+                                                 src_outport="South",
+                                                 dst_inport="North",
+                                                 latency = link_latency,
+                                                 weight=1))
+                        link_count += 1
 
 
         ##### Chiplet to interposer connections
 
+        # (chiplet router, interposer router, chiplet outport,
+        #  interposer outport) for each chiplet, in the order the
+        # custom routing indexes them (column in the chiplet)
+        boundaries = []
+        for (c, (side, edge, offset, reverse)) in enumerate(self.chiplets):
+            edge_row = 0 if edge == "South" else self.chiplet_rows - 1
+            if side in ("West", "East"):
+                edge_len = self.interposer_rows
+            else:
+                edge_len = self.interposer_cols
+            assert(offset + self.chiplet_cols <= edge_len)
+
+            chiplet_boundaries = []
+            for col in xrange(self.chiplet_cols):
+                chiplet_r = c * chiplet_size + edge_row * self.chiplet_cols \
+                            + col
+                pos = offset + (self.chiplet_cols - 1 - col if reverse
+                                else col)
+                if side == "West":
+                    (x, y) = (0, pos)
+                elif side == "East":
+                    (x, y) = (self.interposer_cols - 1, pos)
+                elif side == "South":
+                    (x, y) = (pos, 0)
+                else:
+                    (x, y) = (pos, self.interposer_rows - 1)
+                interposer_r = interposer_base + y * self.interposer_cols + x
+                chiplet_boundaries.append((chiplet_r, interposer_r,
+                                           edge, side))
+            boundaries.append(chiplet_boundaries)
+
         print("Creating Chiplet and interposer connections")
-        
-        print("1. Creating Chiplet1 and interposer connections")
-        print "Router " + get_id(routers[0]) + " created a link to Router " +  get_id(routers[48])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[0],
-                                 dst_node=routers[48],
-                                 src_outport="South",
-                                 dst_inport="West",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[1]) + " created a link to Router " +  get_id(routers[52])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[1],
-                                 dst_node=routers[52],
-                                 src_outport="South",
-                                 dst_inport="West",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[2]) + " created a link to Router " +  get_id(routers[56])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[2],
-                                 dst_node=routers[56],
-                                 src_outport="South",
-                                 dst_inport="West",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[3]) + " created a link to Router " +  get_id(routers[60])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[3],
-                                 dst_node=routers[60],
-                                 src_outport="South",
-                                 dst_inport="West",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-
-        print "Router " + get_id(routers[48]) + " created a link to Router " +  get_id(routers[0])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[48],
-                                 dst_node=routers[0],
-                                 src_outport="West",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[52]) + " created a link to Router " +  get_id(routers[1])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[52],
-                                 dst_node=routers[1],
-                                 src_outport="West",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[56]) + " created a link to Router " +  get_id(routers[2])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[56],
-                                 dst_node=routers[2],
-                                 src_outport="West",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[60]) + " created a link to Router " +  get_id(routers[3])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[60],
-                                 dst_node=routers[3],
-                                 src_outport="West",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print("2. Creating Chiplet2 and interposer connections")
-        print "Router " + get_id(routers[16]) + " created a link to Router " +  get_id(routers[63])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[16],
-                                 dst_node=routers[63],
-                                 src_outport="South",
-                                 dst_inport="East",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[17]) + " created a link to Router " +  get_id(routers[59])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[17],
-                                 dst_node=routers[59],
-                                 src_outport="South",
-                                 dst_inport="East",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[18]) + " created a link to Router " +  get_id(routers[55])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[18],
-                                 dst_node=routers[55],
-                                 src_outport="South",
-                                 dst_inport="East",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[19]) + " created a link to Router " +  get_id(routers[51])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[19],
-                                 dst_node=routers[51],
-                                 src_outport="South",
-                                 dst_inport="East",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[63]) + " created a link to Router " +  get_id(routers[16])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[63],
-                                 dst_node=routers[16],
-                                 src_outport="East",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[59]) + " created a link to Router " +  get_id(routers[17])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[59],
-                                 dst_node=routers[17],
-                                 src_outport="East",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[55]) + " created a link to Router " +  get_id(routers[18])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[55],
-                                 dst_node=routers[18],
-                                 src_outport="East",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-    
-
-        print "Router " + get_id(routers[51]) + " created a link to Router " +  get_id(routers[19])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[51],
-                                 dst_node=routers[19],
-                                 src_outport="East",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print("3. Creating Chiplet3 and interposer connections")
-        print "Router " + get_id(routers[44]) + " created a link to Router " +  get_id(routers[48])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[44],
-                                 dst_node=routers[48],
-                                 src_outport="North",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[45]) + " created a link to Router " +  get_id(routers[49])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[45],
-                                 dst_node=routers[49],
-                                 src_outport="North",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[46]) + " created a link to Router " +  get_id(routers[50])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[46],
-                                 dst_node=routers[50],
-                                 src_outport="North",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[47]) + " created a link to Router " +  get_id(routers[51])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[47],
-                                 dst_node=routers[51],
-                                 src_outport="North",
-                                 dst_inport="South",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[48]) + " created a link to Router " +  get_id(routers[44])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[48],
-                                 dst_node=routers[44],
-                                 src_outport="South",
-                                 dst_inport="North",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-        
-        print "Router " + get_id(routers[49]) + " created a link to Router " +  get_id(routers[45])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[49],
-                                 dst_node=routers[45],
-                                 src_outport="South",
-                                 dst_inport="North",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[50]) + " created a link to Router " +  get_id(routers[46])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[50],
-                                 dst_node=routers[46],
-                                 src_outport="South",
-                                 dst_inport="North",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
-
-        print "Router " + get_id(routers[51]) + " created a link to Router " +  get_id(routers[47])
-        int_links.append(IntLink(link_id=link_count,
-                                 src_node=routers[51],
-                                 dst_node=routers[47],
-                                 src_outport="South",
-                                 dst_inport="North",
-                                 latency = link_latency,
-                                 weight=1))
-        link_count += 1
 
+        for (c, chiplet_boundaries) in enumerate(boundaries):
+            print("%d. Creating Chiplet%d and interposer connections" \
+                  % (c + 1, c + 1))
+            for (chiplet_r, interposer_r, down, up) in chiplet_boundaries:
+                print "Router " + get_id(routers[chiplet_r]) + " created a link to Router " +  get_id(routers[interposer_r])
+                int_links.append(IntLink(link_id=link_count,
+                                         src_node=routers[chiplet_r],
+                                         dst_node=routers[interposer_r],
+                                         src_outport=down,
+                                         dst_inport=up,
+                                         latency = link_latency,
+                                         weight=1))
+                link_count += 1
+
+            for (chiplet_r, interposer_r, down, up) in chiplet_boundaries:
+                print "Router " + get_id(routers[interposer_r]) + " created a link to Router " +  get_id(routers[chiplet_r])
+                int_links.append(IntLink(link_id=link_count,
+                                         src_node=routers[interposer_r],
+                                         dst_node=routers[chiplet_r],
+                                         src_outport=up,
+                                         dst_inport=down,
+                                         latency = link_latency,
+                                         weight=1))
+                link_count += 1
+
+        # Chiplet layout for the custom routing (garnet only)
+        if hasattr(network, "router_region"):
+            router_region = []
+            router_x = []
+            router_y = []
+            for (region, (base, num_rows, num_columns)) in enumerate(regions):
+                for r in xrange(num_rows * num_columns):
+                    router_region.append(region)
+                    router_x.append(r % num_columns)
+                    router_y.append(r / num_columns)
+            network.router_region = router_region
+            network.router_x = router_x
+            network.router_y = router_y
+            network.interposer_region = interposer_region
+            flat = [b for chiplet_boundaries in boundaries
+                      for b in chiplet_boundaries]
+            network.boundary_routers = [b[0] for b in flat]
+            network.boundary_interposer = [b[1] for b in flat]
+            network.boundary_down = [b[2] for b in flat]
+            network.boundary_up = [b[3] for b in flat]
         network.int_links = int_links
 
 def get_id(node) :
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+// Credit-path microbenchmark.
+// Times N credits through the return path, InputUnit queue -> CreditLink
+// -> OutputUnit, with the creditBuffer rings the tree uses now and with
+// the path they replaced: a heap-allocated flit-derived Credit in two
+// time-ordered heap flitBuffers, deleted by the consumer. The old Credit
+// is mirrored below with the fields it inherited from flit; its NetDest
+// is left empty, so the old path is, if anything, timed too fast.
+//
+// build, from gem5/ after building build/Garnet_standalone:
+//   g++ -O2 -std=c++11 -Isrc -Ibuild/Garnet_standalone
+//       my_scripts/credit_bench.cc
+//       src/mem/ruby/network/garnet2.0/Credit.cc
+//       src/mem/ruby/network/garnet2.0/creditBuffer.cc -o credit_bench
+// usage: ./credit_bench [credits] [in flight]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/creditBuffer.hh"
+
+// The baseline Credit: a flit plus the free signal
+class LegacyCredit
+{
+  public:
+    LegacyCredit(int vc, bool is_free_signal, Cycles curTime)
+        : m_id(0), m_vnet(0), m_vc(vc), routedSwap(false), m_size(0),
+          m_time(curTime), m_type(CREDIT_HEAD_), m_outport(-1),
+          m_is_free_signal(is_free_signal)
+    {}
+
+    int get_id() const { return m_id; }
+    int get_vc() const { return m_vc; }
+    Cycles get_time() const { return m_time; }
+    void set_time(Cycles time) { m_time = time; }
+    bool is_free_signal() const { return m_is_free_signal; }
+
+    static bool
+    greater(LegacyCredit *n1, LegacyCredit *n2)
+    {
+        if (n1->get_time() == n2->get_time())
+            return (n1->get_id() > n2->get_id());
+        else
+            return (n1->get_time() > n2->get_time());
+    }
+
+  private:
+    int m_id;
+    int m_vnet;
+    int m_vc;
+    bool routedSwap;
+    // RouteInfo: vnet, net_dest, src_ni, src_router, dest_ni,
+    // dest_router, hops_traversed
+    int m_route_vnet;
+    std::vector<std::vector<uint64_t> > m_route_net_dest;
+    int m_route_ids[5];
+    int m_size;
+    Cycles m_enqueue_time, m_dequeue_time, m_time;
+    flit_type m_type;
+    std::shared_ptr<void> m_msg_ptr;
+    int m_outport;
+    std::string m_outport_dir;
+    Cycles src_delay;
+    std::pair<flit_stage, Cycles> m_stage;
+    bool m_is_free_signal;
+};
+
+// The baseline heap-ordered flitBuffer
+class LegacyBuffer
+{
+  public:
+    bool
+    isReady(Cycles curTime) const
+    {
+        return (!m_buffer.empty() && m_buffer.front()->get_time() <= curTime);
+    }
+
+    LegacyCredit *
+    getTopFlit()
+    {
+        LegacyCredit *f = m_buffer.front();
+        std::pop_heap(m_buffer.begin(), m_buffer.end(),
+                      LegacyCredit::greater);
+        m_buffer.pop_back();
+        return f;
+    }
+
+    void
+    insert(LegacyCredit *flt)
+    {
+        m_buffer.push_back(flt);
+        std::push_heap(m_buffer.begin(), m_buffer.end(),
+                       LegacyCredit::greater);
+    }
+
+  private:
+    std::vector<LegacyCredit *> m_buffer;
+};
+
+// One credit is sent per cycle and takes 'in_flight' cycles to reach
+// the link; the link adds a cycle, like CreditLink with latency 1.
+static long
+run_legacy(long credits, int in_flight)
+{
+    LegacyBuffer src, link;
+    long sum = 0;
+    for (long t = 0; t < credits + in_flight + 2; t++) {
+        Cycles now(t);
+        if (t < credits)
+            src.insert(new LegacyCredit(t % 8, t & 1,
+                                        Cycles(t + in_flight)));
+        while (src.isReady(now)) {
+            LegacyCredit *t_credit = src.getTopFlit();
+            t_credit->set_time(Cycles(t + 1));
+            link.insert(t_credit);
+        }
+        while (link.isReady(now)) {
+            LegacyCredit *t_credit = link.getTopFlit();
+            sum += t_credit->get_vc() + t_credit->is_free_signal();
+            delete t_credit;
+        }
+    }
+    return sum;
+}
+
+static long
+run_ring(long credits, int in_flight)
+{
+    creditBuffer src, link;
+    long sum = 0;
+    for (long t = 0; t < credits + in_flight + 2; t++) {
+        Cycles now(t);
+        if (t < credits)
+            src.insert(Credit(t % 8, t & 1, Cycles(t + in_flight)));
+        while (src.isReady(now)) {
+            Credit credit = src.getTopCredit();
+            credit.set_time(Cycles(t + 1));
+            link.insert(credit);
+        }
+        while (link.isReady(now)) {
+            Credit credit = link.getTopCredit();
+            sum += credit.get_vc() + credit.is_free_signal();
+        }
+    }
+    return sum;
+}
+
+template <typename Run>
+static double
+time_ns(Run run, long credits, int in_flight, long &sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    sum = run(credits, in_flight);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           credits;
+}
+
+int
+main(int argc, char **argv)
+{
+    long credits = (argc > 1) ? atol(argv[1]) : 10000000;
+    int in_flight = (argc > 2) ? atoi(argv[2]) : 4;
+
+    long legacy_sum, ring_sum;
+    // best of three, after a warm-up run of each
+    double legacy_ns = time_ns(run_legacy, credits, in_flight, legacy_sum);
+    double ring_ns = time_ns(run_ring, credits, in_flight, ring_sum);
+    for (int i = 0; i < 3; i++) {
+        legacy_ns = std::min(legacy_ns,
+            time_ns(run_legacy, credits, in_flight, legacy_sum));
+        ring_ns = std::min(ring_ns,
+            time_ns(run_ring, credits, in_flight, ring_sum));
+    }
+
+    if (legacy_sum != ring_sum) {
+        std::cerr << "credit paths disagree: " << legacy_sum << " vs "
+                  << ring_sum << std::endl;
+        return 1;
+    }
+
+    std::cout << "credits: " << credits << ", in flight: " << in_flight
+              << std::endl;
+    std::cout << "heap Credit + flitBuffer: " << legacy_ns
+              << " ns/credit" << std::endl;
+    std::cout << "creditBuffer ring:        " << ring_ns
+              << " ns/credit" << std::endl;
+    std::cout << "speedup: " << legacy_ns / ring_ns << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+#include "mem/ruby/network/garnet2.0/ChipletLayout.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+
+ChipletLayout::ChipletLayout()
+    : m_interposer(-1), m_num_boundaries(0)
+{
+}
+
+void
+ChipletLayout::init(int num_routers,
+                    const std::vector<int> &router_region,
+                    const std::vector<int> &router_x,
+                    const std::vector<int> &router_y,
+                    int interposer_region,
+                    const std::vector<int> &boundary_routers,
+                    const std::vector<int> &boundary_interposer,
+                    const std::vector<std::string> &boundary_down,
+                    const std::vector<std::string> &boundary_up)
+{
+    if (router_region.empty())
+        return;
+
+    if (router_region.size() != num_routers ||
+        router_x.size() != num_routers ||
+        router_y.size() != num_routers)
+        fatal("Chiplet layout: expected region, x and y for each of "
+              "the %d routers\n", num_routers);
+
+    int num_regions = 0;
+    for (int router = 0; router < num_routers; router++) {
+        if (router_region[router] < 0 || router_x[router] < 0 ||
+            router_y[router] < 0)
+            fatal("Chiplet layout: router %d has a negative region or "
+                  "coordinate\n", router);
+        num_regions = std::max(num_regions, router_region[router] + 1);
+    }
+
+    if (interposer_region < 0 || interposer_region >= num_regions)
+        fatal("Chiplet layout: interposer region %d has no routers\n",
+              interposer_region);
+
+    int num_boundaries = boundary_routers.size();
+    if (boundary_interposer.size() != num_boundaries ||
+        boundary_down.size() != num_boundaries ||
+        boundary_up.size() != num_boundaries)
+        fatal("Chiplet layout: boundary lists differ in length\n");
+
+    m_region = router_region;
+    m_x = router_x;
+    m_y = router_y;
+    m_interposer = interposer_region;
+    m_num_boundaries = num_boundaries;
+    m_boundaries.assign(num_regions, std::vector<Boundary>());
+    m_routers.assign(num_regions, std::vector<int>());
+    for (int i = 0; i < num_routers; i++)
+        m_routers[m_region[i]].push_back(i);
+
+    for (int i = 0; i < num_boundaries; i++) {
+        Boundary b;
+        b.router = boundary_routers[i];
+        b.interposer_router = boundary_interposer[i];
+
+        if (b.router < 0 || b.router >= num_routers ||
+            b.interposer_router < 0 || b.interposer_router >= num_routers)
+            fatal("Chiplet layout: boundary %d names an unknown router\n",
+                  i);
+        if (m_region[b.router] == m_interposer ||
+            m_region[b.interposer_router] != m_interposer)
+            fatal("Chiplet layout: boundary %d must link a chiplet router "
+                  "to an interposer router\n", i);
+
+        b.down = intern_port_dirn(boundary_down[i]);
+        b.up = intern_port_dirn(boundary_up[i]);
+        b.index = i;
+        m_boundaries[m_region[b.router]].push_back(b);
+    }
+
+    for (int region = 0; region < num_regions; region++) {
+        if (region != m_interposer && m_boundaries[region].empty())
+            fatal("Chiplet layout: chiplet %d has no boundary router\n",
+                  region);
+    }
+}
+
+int
+ChipletLayout::routerAt(int region, int x, int y) const
+{
+    for (int router : m_routers[region]) {
+        if (m_x[router] == x && m_y[router] == y)
+            return router;
+    }
+    return -1;
+}
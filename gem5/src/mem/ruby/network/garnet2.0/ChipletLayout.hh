@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_CHIPLETLAYOUT_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_CHIPLETLAYOUT_HH__
+
+#include <string>
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+
+// Layout of a chiplet system for the CUSTOM_ routing, as described by
+// the topology (see configs/topologies/Het_meshs.py). Every router
+// belongs to one region: a chiplet, or the interposer. Each region is
+// a mesh and routers carry (x, y) coordinates within it. Boundary
+// routers link a chiplet to one interposer router.
+class ChipletLayout
+{
+  public:
+    struct Boundary
+    {
+        int router;             // chiplet router
+        int interposer_router;  // interposer router it is linked to
+        PortDirn down;          // outport of router towards the interposer
+        PortDirn up;            // outport of interposer_router towards it
+        int index;              // position in the topology's list
+    };
+
+    ChipletLayout();
+
+    // Check and index the topology's description. Lists are per router
+    // (region, x, y) and per boundary link; fatal() on an inconsistent
+    // layout.
+    void init(int num_routers,
+              const std::vector<int> &router_region,
+              const std::vector<int> &router_x,
+              const std::vector<int> &router_y,
+              int interposer_region,
+              const std::vector<int> &boundary_routers,
+              const std::vector<int> &boundary_interposer,
+              const std::vector<std::string> &boundary_down,
+              const std::vector<std::string> &boundary_up);
+
+    // false if the topology did not describe a layout
+    bool isValid() const { return !m_region.empty(); }
+
+    int region(int router) const { return m_region[router]; }
+    int x(int router) const { return m_x[router]; }
+    int y(int router) const { return m_y[router]; }
+    int interposer() const { return m_interposer; }
+
+    int numRegions() const { return m_boundaries.size(); }
+    int numBoundaries() const { return m_num_boundaries; }
+
+    // Boundaries of a chiplet, in the order the topology listed them
+    int numBoundaries(int region) const
+    { return m_boundaries[region].size(); }
+    const Boundary &boundary(int region, int idx) const
+    { return m_boundaries[region][idx]; }
+
+    // Routers of a region, in id order
+    const std::vector<int> &routers(int region) const
+    { return m_routers[region]; }
+    // Router at (x, y) of a region, -1 if there is none
+    int routerAt(int region, int x, int y) const;
+
+  private:
+    std::vector<int> m_region;
+    std::vector<int> m_x;
+    std::vector<int> m_y;
+    int m_interposer;
+    int m_num_boundaries;
+
+    // indexed by region
+    std::vector<std::vector<Boundary>> m_boundaries;
+    std::vector<std::vector<int>> m_routers;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_CHIPLETLAYOUT_HH__
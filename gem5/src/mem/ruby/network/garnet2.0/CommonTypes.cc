@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+
+#include <vector>
+
+#include "base/logging.hh"
+
+// Name table for PortDirn. The mesh directions are fixed; any other
+// direction string seen in the topology is appended on first use.
+static std::vector<std::string> &
+port_dirn_names()
+{
+    static std::vector<std::string> names =
+        {"Local", "North", "East", "South", "West"};
+    return names;
+}
+
+PortDirn
+intern_port_dirn(const std::string &name)
+{
+    std::vector<std::string> &names = port_dirn_names();
+    for (int i = 0; i < names.size(); i++) {
+        if (names[i] == name)
+            return (PortDirn) i;
+    }
+
+    if (names.size() >= MAX_PORT_DIRN_)
+        fatal("Too many distinct port directions, cannot intern %s\n",
+              name);
+
+    names.push_back(name);
+    return (PortDirn) (names.size() - 1);
+}
+
+const std::string &
+port_dirn_name(PortDirn dirn)
+{
+    static const std::string unknown = "Unknown";
+    std::vector<std::string> &names = port_dirn_names();
+    if (dirn < 0 || dirn >= names.size())
+        return unknown;
+    return names[dirn];
+}
@@ -34,7 +34,10 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_COMMONTYPES_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_COMMONTYPES_HH__
 #define MY_PRINT 0
-#define INTERPOSR_RANDOM_ROUTING_EN 1
+#include <cstdint>
+#include <iostream>
+#include <string>
+
 #include "mem/ruby/common/NetDest.hh"
 
 // All common enums and typedefs go here
@@ -52,16 +55,63 @@ enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, TURN_MODEL_OBLIVIOUS_ = 2,
                         RANDOM_ADAPTIVE_ = 5, CUSTOM_ = 6,
                         NUM_ROUTING_ALGORITHM_};
 //SWAP_GARNET_2.0_MERGE
-enum when_to_swap { TDM_ = 1, _2_TDM_ = 2, _4_TDM_ = 3, _8_TDM_ = 4,
-                    _16_TDM_ =5, _32_TDM_ = 6, _64_TDM_ = 7, _512_TDM_ = 8,
-					_1024_TDM_ = 9, _2048_TDM_ = 10 };
 enum which_to_swap { DISABLE_LOCAL_SWAP_ = 1, ENABLE_LOCAL_SWAP_ = 2 };
+enum SwitchAllocatorType { LOOP_SA_ = 0, BITMASK_SA_ = 1, CHECK_SA_ = 2,
+                           NUM_SWITCH_ALLOCATOR_ };
+// How chiplet (CUSTOM_) routing picks the boundary routers of a packet
+enum BoundarySelection { STATIC_HASH_BOUNDARY_ = 0,
+                         LEAST_LOADED_BOUNDARY_ = 1,
+                         POWER_OF_TWO_BOUNDARY_ = 2,
+                         NUM_BOUNDARY_SELECTION_ };
+// Two-phase oblivious routing across the interposer: through a random
+// interposer router (Valiant) or one in the minimal quadrant (ROMM)
+enum InterposerIntermediate { NO_INTERMEDIATE_ = 0,
+                              VALIANT_INTERMEDIATE_ = 1,
+                              ROMM_INTERMEDIATE_ = 2,
+                              NUM_INTERPOSER_INTERMEDIATE_ };
+// Variants of the chiplet (CUSTOM_) routing, see RoutingUnit.cc
+enum RoutingVariant { ISWAP_ROUTING_ = 0, DEADLOCK_CHECK_ROUTING_ = 1,
+                      COMPOSABLE_ROUTING_ = 2, BP_ROUTING_ = 3,
+                      WRKN_ROUTING_ = 4, DUATO_ROUTING_ = 5,
+                      NUM_ROUTING_VARIANT_ };
+
+// Port directions are interned to small integers. The topology hands us
+// strings ("North", "Local", ...); they are mapped once when the links
+// are made, so the per-hop path only ever compares integers. Directions
+// other than the mesh ones get the next free id, up to MAX_PORT_DIRN_.
+enum PortDirn { UNKNOWN_DIRN_ = -1, LOCAL_DIRN_ = 0, NORTH_DIRN_ = 1,
+                EAST_DIRN_ = 2, SOUTH_DIRN_ = 3, WEST_DIRN_ = 4,
+                NUM_MESH_DIRN_ = 5, MAX_PORT_DIRN_ = 16 };
+
+PortDirn intern_port_dirn(const std::string &name);
+const std::string &port_dirn_name(PortDirn dirn);
+
+inline std::ostream&
+operator<<(std::ostream& out, PortDirn dirn)
+{
+    return out << port_dirn_name(dirn);
+}
+
+// Longest path a source routed flit can carry, and most source routed
+// packets in flight (RouteInfo::path_hop and path_id)
+#define MAX_SOURCE_ROUTE_HOPS_ 64
+#define MAX_SOURCE_ROUTES_ 32767
+
+// Outport to take at each router of a source routed packet's path.
+// Kept out of line, in a pool of GarnetNetwork shared by the flits of
+// the packet, so RouteInfo only carries its index.
+struct SourceRoute
+{
+    int len;
+    uint8_t port[MAX_SOURCE_ROUTE_HOPS_];
+};
 
+// Plain-old-data route descriptor carried by every flit and passed by
+// const reference through route computation. Table-based routing looks
+// up dest_ni in a per-router table, so no NetDest is carried.
 struct RouteInfo
 {
-    // destination format for table-based routing
     int vnet;
-    NetDest net_dest;
 
     // src and dest format for topology-specific routing
     int src_ni;
@@ -70,8 +120,42 @@ struct RouteInfo
     int dest_ni;
     int dest_router;
     int hops_traversed;
+
+    // Chiplet routing: index of the boundary of the source chiplet the
+    // packet goes down through and of the destination chiplet it comes
+    // up through; -1 if it does not leave or enter a chiplet
+    int egress_boundary;
+    int ingress_boundary;
+
+    // Two-phase interposer routing: the interposer router the packet
+    // first heads for, -1 if none, and whether it got there. The flag
+    // is set once, by the first router with that id to see the flit.
+    int intermediate;
+    bool intermediate_reached;
+
+    // Source routing: the index of the router the flit is in along its
+    // path and the path in GarnetNetwork's pool, -1 when the route is
+    // computed hop by hop. Both fit next to the flag above, so they
+    // cost nothing when source routing is off.
+    int8_t path_hop;
+    int16_t path_id;
 };
 
+// Position of a router: the region (chiplet) it belongs to and its
+// column and row in that region's mesh. y grows to the North.
+struct RouterCoord
+{
+    int region;
+    int x;
+    int y;
+};
+
+// Weight of one free VC against credits in adaptive outport selection
+#define FREE_VC_SCORE_ 1024
+
 #define INFINITE_ 10000
+// unlike INFINITE_, never reached by a running simulation
+#define NEVER_READY_ Cycles(MaxTick)
+#define INVALID_PORT_ -1
 
 #endif //__MEM_RUBY_NETWORK_GARNET2_0_COMMONTYPES_HH__
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#include "mem/ruby/network/garnet2.0/CongestionSideband.hh"
+
+#include "base/logging.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
+#include "mem/ruby/network/garnet2.0/Router.hh"
+
+CongestionSideband::CongestionSideband(GarnetNetwork *net_ptr,
+                                       uint32_t period, uint32_t latency,
+                                       uint32_t local_weight, uint32_t bits)
+    : Consumer(net_ptr), m_net_ptr(net_ptr), m_period(period),
+      m_local_weight(local_weight), m_bits(bits), m_num_routers(0),
+      m_epoch(0)
+{
+    assert(period > 0);
+    if (local_weight > 100)
+        fatal("Congestion sideband local weight is a percentage, not %d\n",
+              local_weight);
+    if (bits == 0 || bits > 16)
+        fatal("Congestion sideband values must be 1 to 16 bits, not %d\n",
+              bits);
+    m_max_value = (1 << bits) - 1;
+    m_delay = std::max((latency + period - 1) / period, (uint32_t) 1);
+    m_depth = m_delay + 1;
+}
+
+void
+CongestionSideband::init()
+{
+    m_num_routers = m_net_ptr->getNumRouters();
+    m_outport.assign(m_num_routers * NUM_MESH_DIRN_, -1);
+    m_neighbor.assign(m_num_routers * NUM_MESH_DIRN_, -1);
+    m_values.assign(m_depth * m_num_routers * NUM_MESH_DIRN_, 0);
+
+    for (int router = 0; router < m_num_routers; router++) {
+        std::vector<OutputUnit *> &output_units =
+            m_net_ptr->getRouter(router)->get_outputUnit_ref();
+        for (int outport = 0; outport < output_units.size(); outport++) {
+            PortDirn dirn = output_units[outport]->get_direction();
+            if (dirn <= LOCAL_DIRN_ || dirn >= NUM_MESH_DIRN_)
+                continue;
+            int idx = router * NUM_MESH_DIRN_ + dirn;
+            m_outport[idx] = outport;
+            m_neighbor[idx] =
+                output_units[outport]->get_downstream_router();
+        }
+    }
+
+    scheduleEvent(Cycles(m_period));
+}
+
+// Busy output VCs of 'outport' over all vnets, scaled to the value range
+int
+CongestionSideband::localOccupancy(int router, int outport)
+{
+    Router *router_ptr = m_net_ptr->getRouter(router);
+    OutputUnit *output_unit = router_ptr->get_outputUnit_ref()[outport];
+    int num_vcs = router_ptr->get_num_vcs();
+
+    int busy = num_vcs;
+    for (int vnet = 0; vnet < router_ptr->get_num_vnets(); vnet++)
+        busy -= output_unit->get_free_vc_count(vnet);
+
+    return busy * m_max_value / num_vcs;
+}
+
+// One update: every router blends each outport's occupancy with what
+// the neighbor behind it published m_delay updates ago, and sends the
+// result upstream over the sideband.
+void
+CongestionSideband::wakeup()
+{
+    int64_t epoch = m_epoch + 1;
+    uint16_t *published = &m_values[slot(epoch)];
+    // nothing has arrived yet during the first m_delay updates
+    const uint16_t *received = NULL;
+    if (epoch >= m_delay)
+        received = &m_values[slot(epoch - m_delay)];
+
+    int updates = 0;
+    for (int router = 0; router < m_num_routers; router++) {
+        for (int dirn = NORTH_DIRN_; dirn < NUM_MESH_DIRN_; dirn++) {
+            int idx = router * NUM_MESH_DIRN_ + dirn;
+            if (m_outport[idx] == -1) {
+                published[idx] = 0;
+                continue;
+            }
+
+            int local = localOccupancy(router, m_outport[idx]);
+            int remote = 0;
+            int neighbor = m_neighbor[idx];
+            if (neighbor != -1 && received != NULL)
+                remote = received[neighbor * NUM_MESH_DIRN_ + dirn];
+
+            published[idx] = (local * m_local_weight +
+                              remote * (100 - m_local_weight)) / 100;
+            updates++;
+        }
+    }
+    m_epoch = epoch;
+
+    #if (MY_PRINT)
+        cout << "CongestionSideband::wakeup() update " << m_epoch
+             << " sent " << updates << " values" << endl;
+    #endif
+
+    m_net_ptr->increment_sideband_updates(updates, updates * m_bits);
+    scheduleEvent(Cycles(m_period));
+}
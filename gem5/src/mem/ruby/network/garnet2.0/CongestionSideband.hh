@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_CONGESTIONSIDEBAND_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_CONGESTIONSIDEBAND_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+
+class GarnetNetwork;
+
+// Regional congestion awareness: every 'period' cycles each router
+// publishes, for each mesh direction, a congestion value that blends the
+// occupancy of its own outport with the value last received from the
+// neighbor in that direction. Values travel over narrow sideband links
+// ('bits' wide) and reach the neighbor 'latency' cycles later, rounded
+// up to whole periods. Adaptive routing reads congestion() to prefer the
+// outport leading into the less congested region.
+class CongestionSideband : public Consumer
+{
+  public:
+    CongestionSideband(GarnetNetwork *net_ptr, uint32_t period,
+                       uint32_t latency, uint32_t local_weight,
+                       uint32_t bits);
+
+    // after the links are made; schedules the first update
+    void init();
+    void wakeup();
+    void print(std::ostream& out) const {};
+
+    // Congestion seen by 'router' towards 'dirn', 0 (idle) to maxValue()
+    inline int
+    congestion(int router, PortDirn dirn) const
+    {
+        assert(dirn > LOCAL_DIRN_ && dirn < NUM_MESH_DIRN_);
+        return m_values[slot(m_epoch) + router * NUM_MESH_DIRN_ + dirn];
+    }
+    inline int maxValue() const { return m_max_value; }
+    inline uint32_t bits() const { return m_bits; }
+
+  private:
+    inline int
+    slot(int64_t epoch) const
+    {
+        return (epoch % m_depth) * m_num_routers * NUM_MESH_DIRN_;
+    }
+    int localOccupancy(int router, int outport);
+
+    GarnetNetwork *m_net_ptr;
+    uint32_t m_period;
+    uint32_t m_local_weight;
+    uint32_t m_bits;
+    int m_max_value;
+    int m_num_routers;
+
+    // updates in flight on a link, so a neighbor reads the value
+    // published m_delay updates ago
+    int m_delay;
+    int m_depth;
+    int64_t m_epoch;
+
+    // [router][dirn]: outport towards dirn and the router behind it,
+    // -1 if there is none
+    std::vector<int> m_outport;
+    std::vector<int> m_neighbor;
+    // m_depth generations of [router][dirn] published values
+    std::vector<uint16_t> m_values;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_CONGESTIONSIDEBAND_HH__
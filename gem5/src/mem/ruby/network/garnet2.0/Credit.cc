@@ -34,13 +34,9 @@
 #include "mem/ruby/network/garnet2.0/Credit.hh"
 
 // Credit Signal for buffers inside VC
-// Carries m_vc (inherits from flit.hh)
-// and m_is_free_signal (whether VC is free or not)
+// Carries m_vc and m_is_free_signal (whether VC is free or not)
 
 Credit::Credit(int vc, bool is_free_signal, Cycles curTime)
+    : m_vc(vc), m_is_free_signal(is_free_signal), m_time(curTime)
 {
-    m_id = 0;
-    m_vc = vc;
-    m_is_free_signal = is_free_signal;
-    m_time = curTime;
 }
@@ -39,22 +39,27 @@
 
 #include "base/types.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
-#include "mem/ruby/network/garnet2.0/flit.hh"
 
 // Credit Signal for buffers inside VC
-// Carries m_vc (inherits from flit.hh)
-// and m_is_free_signal (whether VC is free or not)
+// Carries m_vc and m_is_free_signal (whether VC is free or not),
+// timestamped with the cycle it becomes visible. Credits are passed
+// by value through creditBuffers; they are never heap allocated.
 
-class Credit : public flit
+class Credit
 {
   public:
-    Credit() {};
+    Credit() : m_vc(-1), m_is_free_signal(false), m_time(0) {}
     Credit(int vc, bool is_free_signal, Cycles curTime);
 
-    bool is_free_signal() { return m_is_free_signal; }
+    int get_vc() const { return m_vc; }
+    bool is_free_signal() const { return m_is_free_signal; }
+    Cycles get_time() const { return m_time; }
+    void set_time(Cycles time) { m_time = time; }
 
   private:
+    int m_vc;
     bool m_is_free_signal;
+    Cycles m_time;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_CREDIT_HH__
@@ -35,13 +35,29 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_CREDITLINK_HH__
 
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+#include "mem/ruby/network/garnet2.0/creditBuffer.hh"
 #include "params/CreditLink.hh"
 
+// Backward flow-control link. Carries Credits by value between
+// creditBuffers instead of flits through flitBuffers; the link timing
+// is the same as NetworkLink's.
 class CreditLink : public NetworkLink
 {
   public:
     typedef CreditLinkParams Params;
-    CreditLink(const Params *p) : NetworkLink(p) {}
+    CreditLink(const Params *p) : NetworkLink(p), credit_srcQueue(nullptr) {}
+
+    void setSourceQueue(creditBuffer *srcQueue);
+    void wakeup();
+
+    inline bool isReady(Cycles curTime)
+    { return creditLinkBuffer.isReady(curTime); }
+
+    inline Credit consumeLink() { return creditLinkBuffer.getTopCredit(); }
+
+  private:
+    creditBuffer creditLinkBuffer;
+    creditBuffer *credit_srcQueue;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_CREDITLINK_HH__
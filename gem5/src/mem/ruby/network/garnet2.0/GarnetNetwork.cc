@@ -72,6 +72,39 @@ GarnetNetwork::GarnetNetwork(const Params* p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
+    assert(p->switch_allocator < NUM_SWITCH_ALLOCATOR_);
+    m_switch_allocator = (SwitchAllocatorType) p->switch_allocator;
+    assert(p->routing_variant < NUM_ROUTING_VARIANT_);
+    m_routing_variant = (RoutingVariant) p->routing_variant;
+    m_source_routing = p->source_routing;
+    assert(p->boundary_selection < NUM_BOUNDARY_SELECTION_);
+    m_boundary_selection = (BoundarySelection) p->boundary_selection;
+    assert(p->interposer_intermediate < NUM_INTERPOSER_INTERMEDIATE_);
+    m_interposer_intermediate =
+        (InterposerIntermediate) p->interposer_intermediate;
+    m_turn_model_name = p->turn_model;
+    m_turn_model_prohibited = p->turn_model_prohibited;
+    m_congestion_sideband = NULL;
+    if (p->congestion_sideband_period > 0)
+        m_congestion_sideband =
+            new CongestionSideband(this, p->congestion_sideband_period,
+                                   p->congestion_sideband_latency,
+                                   p->congestion_sideband_weight,
+                                   p->congestion_sideband_bits);
+    m_wait_for_graph = NULL;
+    if (p->deadlock_detect_period > 0)
+        m_wait_for_graph =
+            new WaitForGraph(this, p->deadlock_detect_period,
+                             p->garnet_deadlock_threshold,
+                             p->deadlock_rotation,
+                             p->rotation_latency);
+    else if (p->deadlock_rotation)
+        fatal("Deadlock rotation needs the wait-for graph "
+              "(deadlock_detect_period)\n");
+    m_chiplet_layout.init(p->routers.size(), p->router_region,
+                          p->router_x, p->router_y, p->interposer_region,
+                          p->boundary_routers, p->boundary_interposer,
+                          p->boundary_down, p->boundary_up);
 
     max_flit_latency = Cycles(0);
     max_flit_network_latency = Cycles(0);
@@ -86,6 +119,7 @@ GarnetNetwork::GarnetNetwork(const Params* p)
 	m_interswap = p->interswap;
 	m_policy = p->policy;
     m_whenToSwap = p->whenToSwap;
+    m_swap_blocked_threshold = p->swap_blocked_threshold;
     m_whichToSwap = p->whichToSwap;
     m_no_is_swap = p->no_is_swap;
     m_occupancy_swap = p->occupancy_swap;
@@ -109,66 +143,13 @@ GarnetNetwork::GarnetNetwork(const Params* p)
             cout << "***********************************" << endl;
         #endif
 
-        if (m_whenToSwap == TDM_) {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << " 'whenToSwap' :::: TDM Swap Policy is used" << endl;
-                cout << "***********************************" << endl;
-            #endif
-        } else if (m_whenToSwap == _2_TDM_) {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << " 'whenToSwap' :::: " << endl;
-                cout << "Swaps will be initiated by the upstream router on "\
-                        "twice its TDM turn. Therefore it has half the "\
-                        "frequency of swaps compared to defualt policy" << endl;
-                cout << "***********************************" << endl;
-            #endif
-        } else if (m_whenToSwap == _4_TDM_) {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << " 'whenToSwap' :::: " << endl;
-                cout << "Swaps will be initiated by the upstream router on "\
-                        "twice its TDM turn. Therefore it has half the "\
-                        "frequency of swaps compared to defualt policy" << endl;
-                cout << "***********************************" << endl;
-            #endif
-        } else if (m_whenToSwap == _8_TDM_) {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << " 'whenToSwap' :::: " << endl;
-                cout << "Swaps will be initiated by the upstream router on "\
-                        "twice its TDM turn. Therefore it has half the "\
-                        "frequency of swaps compared to defualt policy" << endl;
-                cout << "***********************************" << endl;
-            #endif
-        } else if (m_whenToSwap == _16_TDM_) {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << " 'whenToSwap' :::: " << endl;
-                cout << "Swaps will be initiated by the upstream router "\
-                        "on its 16th TDM turn. Therefore it has 1/16th "\
-                        "of the frequency of swaps compared to default policy" << endl;
-                cout << "***********************************" << endl;
-            #endif
-        } else if (m_whenToSwap == _32_TDM_) {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << " 'whenToSwap' :::: " << endl;
-                cout << "Swaps will be initiated by the upstream router "\
-                        "on its 32th TDM turn. Therefore it has 1/32th "\
-                        "of the frequency of swaps compared to default policy" << endl;
-                cout << "***********************************" << endl;
-            #endif
-        } else {
-            #if (MY_PRINT)
-                cout << "***********************************" << endl;
-                cout << "Unimplermented 'whenToSwap' knob has been selected."\
-                        " Aborting simulation..." << endl;
-                cout << "***********************************" << endl;
-            #endif
-            // assert(0);
-        }
+        #if (MY_PRINT)
+            cout << "***********************************" << endl;
+            cout << " 'whenToSwap' :::: each router initiates swaps "\
+                    "every " << m_whenToSwap << " x num-routers "\
+                    "cycles (TDM)" << endl;
+            cout << "***********************************" << endl;
+        #endif
 
         if (m_whichToSwap == DISABLE_LOCAL_SWAP_) {
             #if(MY_PRINT)
@@ -270,6 +251,10 @@ GarnetNetwork::init()
     assert(m_topology_ptr != NULL);
     m_topology_ptr->createLinks(this);
 
+    // All links are in place: flatten the routing tables
+    for (int i = 0; i < m_routers.size(); i++)
+        m_routers[i]->get_routingUnit_ref()->buildDestinationTable(m_nodes);
+
     // Initialize topology specific parameters
     if (getNumRows() > 0) {
         // Only for Mesh topology
@@ -284,6 +269,42 @@ GarnetNetwork::init()
         m_num_cols = -1;
     }
 
+    // Router coordinates, looked up by the direction based routing
+    // algorithms. A chiplet layout from the topology takes precedence
+    // over the plain mesh numbering.
+    m_router_coords.resize(m_routers.size());
+    for (int i = 0; i < m_routers.size(); i++) {
+        RouterCoord &coord = m_router_coords[i];
+        if (m_chiplet_layout.isValid()) {
+            coord.region = m_chiplet_layout.region(i);
+            coord.x = m_chiplet_layout.x(i);
+            coord.y = m_chiplet_layout.y(i);
+        } else if (m_num_cols > 0) {
+            coord.region = 0;
+            coord.x = i % m_num_cols;
+            coord.y = i / m_num_cols;
+        } else {
+            coord.region = coord.x = coord.y = -1;
+        }
+    }
+
+    // Turn model tables, for the turn models and for VC 0 of random
+    // oblivious routing; plain meshes only
+    if (m_routing_algorithm == TURN_MODEL_OBLIVIOUS_ ||
+        m_routing_algorithm == TURN_MODEL_ADAPTIVE_ ||
+        m_routing_algorithm == RANDOM_OBLIVIOUS_) {
+        if (m_num_cols <= 0 || m_chiplet_layout.isValid())
+            fatal("Turn model routing needs a mesh (num_rows) without a "
+                  "chiplet layout\n");
+        m_turn_model.init(m_turn_model_name, m_turn_model_prohibited,
+                          m_router_coords, m_num_rows, m_num_cols);
+    }
+
+    if (m_congestion_sideband != NULL)
+        m_congestion_sideband->init();
+    if (m_wait_for_graph != NULL)
+        m_wait_for_graph->init();
+
     // FaultModel: declare each router to the fault model
     if (isFaultModelEnabled()) {
         for (vector<Router*>::const_iterator i = m_routers.begin();
@@ -312,6 +333,8 @@ GarnetNetwork::~GarnetNetwork()
 {
     deletePointers(m_routers);
     deletePointers(m_nis);
+    delete m_congestion_sideband;
+    delete m_wait_for_graph;
     deletePointers(m_networklinks);
     deletePointers(m_creditlinks);
 }
@@ -343,7 +366,7 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
 
-    PortDirection dst_inport_dirn = "Local";
+    PortDirn dst_inport_dirn = LOCAL_DIRN_;
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
     m_nis[src]->addOutPort(net_link, credit_link, dest);
 }
@@ -377,7 +400,7 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
 
-    PortDirection src_outport_dirn = "Local";
+    PortDirn src_outport_dirn = LOCAL_DIRN_;
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
         routing_table_entry,
         link->m_weight, credit_link);
@@ -410,10 +433,20 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
 
-    m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
-    m_routers[src]->addOutPort(src_outport_dirn, net_link,
-        routing_table_entry,
+    // Directions are interned here, once; the routers never see the
+    // topology strings.
+    m_routers[dest]->addInPort(intern_port_dirn(dst_inport_dirn),
+        net_link, credit_link);
+    m_routers[src]->addOutPort(intern_port_dirn(src_outport_dirn),
+        net_link, routing_table_entry,
         link->m_weight, credit_link);
+
+    // remember both ends of the link, for source routing and iSWAP;
+    // no mesh numbering is assumed
+    m_routers[src]->get_outputUnit_ref().back()->set_downstream(dest,
+        m_routers[dest]->get_num_inports() - 1);
+    m_routers[dest]->get_inputUnit_ref().back()->set_upstream(src,
+        m_routers[src]->get_num_outports() - 1);
 }
 
 // Total routers in the network
@@ -430,227 +463,129 @@ GarnetNetwork::get_router_id(int ni)
     return m_nis[ni]->get_router_id();
 }
 
-int
-GarnetNetwork::get_downstreamId( PortDirection outport_dir, int upstream_id )
+void
+GarnetNetwork::selectBoundaries(RouteInfo &route)
 {
-    int num_cols = getNumCols();
-    int downstream_id = -1; // router_id for downstream router
-    /*outport direction fromt he flit for this router*/
-    if (outport_dir == "East") {
-        downstream_id = upstream_id + 1;
-    }
-    else if (outport_dir == "West") {
-        downstream_id = upstream_id - 1;
-    }
-    else if (outport_dir == "North") {
-        downstream_id = upstream_id + num_cols;
-    }
-    else if (outport_dir == "South") {
-        downstream_id = upstream_id - num_cols;
-    }
-    else if (outport_dir == "Local"){
-        #if (MY_PRINT)
-            cout << "outport_dir: " << outport_dir << endl;
-        #endif
-        assert(0);
-        return -1;
-    }
-    else {
-        #if (MY_PRINT)
-            cout << "outport_dir: " << outport_dir << endl;
-        #endif
-        assert(0); // for completion of if-else chain
-        return -1;
+    if (m_routing_algorithm == CUSTOM_) {
+        m_routers[route.src_router]->get_routingUnit_ref()->
+            selectBoundaries(route);
+    } else {
+        route.egress_boundary = -1;
+        route.ingress_boundary = -1;
     }
-
-    return downstream_id;
 }
 
-Router*
-GarnetNetwork::get_downstreamRouter(PortDirection outport_dir, int upstream_id)
+void
+GarnetNetwork::selectIntermediate(RouteInfo &route)
 {
-    int router_id = -1;
-    router_id = get_downstreamId( outport_dir, upstream_id);
-//    cout << "downstream router-id: " << router_id << endl;
-    // assert(router_id >= 0);
-    if ((router_id < 0) || (router_id >= getNumRouters()))
-        return NULL;
-    else
-        return m_routers[router_id];
+    route.intermediate = -1;
+    route.intermediate_reached = false;
+    if (m_routing_algorithm == CUSTOM_ &&
+        m_interposer_intermediate != NO_INTERMEDIATE_) {
+        m_routers[route.src_router]->get_routingUnit_ref()->
+            selectIntermediate(route);
+    }
 }
 
-
-PortDirection
-GarnetNetwork::get_downstreamDirn( PortDirection outport_dir )
+// Walk the flit from its source router to its destination NI, asking
+// each router's RoutingUnit for the outport and following the links.
+// Only oblivious routing is allowed here (checked in RoutingUnit::init),
+// so the path is the one hop by hop routing could have taken.
+void
+GarnetNetwork::computeSourceRoute(RouteInfo &route, int vc)
 {
-    // 'inport_dirn' of the downstream router
-    // NOTE: it's Mesh specific
-    PortDirection inport_dirn;
-    if (outport_dir == "East") {
-        inport_dirn = "West";
-    } else if (outport_dir == "West") {
-        inport_dirn = "East";
-    } else if (outport_dir == "North") {
-        inport_dirn = "South";
-    } else if (outport_dir == "South") {
-        inport_dirn = "North";
-    } else if (outport_dir == "Local") {
-        assert(0); // shouldn't come here,,,
+    int router_id = route.src_router;
+    RoutingUnit *routing_unit = m_routers[router_id]->get_routingUnit_ref();
+    PortDirn inport_dirn = LOCAL_DIRN_;
+    int inport = routing_unit->inportIdx(inport_dirn);
+
+    // the flit passes the intermediate again on its way
+    bool intermediate_reached = route.intermediate_reached;
+
+    int path_id;
+    if (m_free_source_routes.empty()) {
+        path_id = m_source_routes.size();
+        if (path_id == MAX_SOURCE_ROUTES_)
+            fatal("More than %d source routed packets in flight\n",
+                  MAX_SOURCE_ROUTES_);
+        m_source_routes.push_back(SourceRoute());
+    } else {
+        path_id = m_free_source_routes.back();
+        m_free_source_routes.pop_back();
+    }
+    SourceRoute &path = m_source_routes[path_id];
+
+    // hop by hop while the path is walked
+    route.path_id = -1;
+    path.len = 0;
+    while (true) {
+        if (route.intermediate == router_id)
+            route.intermediate_reached = true;
+        int outport = routing_unit->outportCompute(route, inport,
+                                                   inport_dirn, vc);
+        if (path.len == MAX_SOURCE_ROUTE_HOPS_)
+            fatal("Source route from router %d to router %d is longer "
+                  "than %d hops\n", route.src_router, route.dest_router,
+                  MAX_SOURCE_ROUTE_HOPS_);
+        assert(outport >= 0 && outport < 256);
+        path.port[path.len++] = outport;
+
+        if (router_id == route.dest_router)
+            break;
+
+        OutputUnit *output_unit =
+            m_routers[router_id]->get_outputUnit_ref()[outport];
+        router_id = output_unit->get_downstream_router();
+        inport = output_unit->get_downstream_inport();
+        assert(router_id != -1);
+
+        routing_unit = m_routers[router_id]->get_routingUnit_ref();
+        inport_dirn = routing_unit->inportDirn(inport);
     }
 
-    return inport_dirn;
+    // the first router advances it to 0
+    route.path_hop = -1;
+    route.path_id = path_id;
+    route.intermediate_reached = intermediate_reached;
 }
 
-
-// if this fucntion returns 'true' initiate bail_out sequence.
-// NOte: it still do bail-put signalling based on invc 0 for ech
-// inport.
-// That is, if outport of flit at invc0 has all downstream router's
-// `is_swap` bit set then it will trigger the bailout sequence.
-// Implecation: More false positives.. not incorrect.
-// Reason: Can introduce many bugs; more code addition wo incentive
+// Deadlock symptom at router my_id; 'true' initiates the bail_out
+// sequence. Read off the blocked cycle records of the SwitchAllocator:
+// the swap candidate (in 'vnet') has waited for a VC for at least
+// swap_blocked_threshold cycles, every VC of the vnet at the downstream
+// inport holds a flit, and both routers have their 'is_swap' bit set,
+// so another swap would only bounce the flits back.
 bool
 GarnetNetwork::chk_deadlck_symptm(int my_id, int vnet)
 {
-
-
-
-    if(curCycle()%1000 == 0)
-        return true;
-     else
-        return false;
-    // -----------------------------
-
-    // movSwapPtr in the end.. first peekTopFlit() of upstream
-    // after checking vc_isEmpty; then check the correspnding
-    // `is_swap` bit of downstream.
     Router* router = m_routers[my_id];
-    // loop over its inport starting from swap_ptr.inport
-    uint32_t orig_inport = router->swap_ptr.inport;
-    uint32_t inport_itr = router->swap_ptr.inport;
-    // Convention: Empty: -1; dontBailOut: 7; bailOut: 1;
-    // std::vector<int> bail_out; // indexed by 'inport'
-    int num_inports = router->get_num_inports();
-    // nothing to worry.. this is just a local variable of this func
-    std::vector<std::vector<int>> bail_out(num_inports);
-    //bail_out.resize(router->get_num_inports());
-    int downstreamId;
-    PortDirection downstreamInportDirn;
-    int downstreamInportId;
-
-    int vcs_per_vnet = router->get_vc_per_vnet();
-    // int vnet = 0;
-    int vc_base = vnet*vcs_per_vnet;
-
-    for (int k = 0; k < num_inports; ++k) {
-        bail_out[k].resize(vcs_per_vnet);
-    }
+    int blocked_cycles = router->swap_candidate_blocked_cycles();
+    if (blocked_cycles < 0 ||
+        blocked_cycles < (int) m_swap_blocked_threshold)
+        return false;
 
-    bool last_itr = false; // flag which when set, would trigger the
-                           // completion of while loop in next iteration.
-
-    while (1) { // loop for populating 'bail_out' for upstream router
-        if (last_itr == true)
-            break; // only exit point from loop
-
-        inport_itr++;
-        if (inport_itr == router->get_num_inports())
-            inport_itr = 0; // looping_over
-
-        if (inport_itr == orig_inport)  // loop completes
-            last_itr = true;
-
-
-        // ------fill bail_out matrix-------
-        // 1. check if vc_isEmpty() is not then peekTopFlit(0)
-        flit* flit_ = NULL; // upstream (my_id)'s flit
-        int upstreamVcId = router->swap_ptr.vcid;
-        assert(upstreamVcId != -1); // vcid shouldn't be -1
-        // loop over all the invc for this given inport of upstream router
-        for(int in_vc = vc_base; in_vc < vc_base + vcs_per_vnet; ++in_vc) {
-
-            if (router->get_inputUnit_ref()[inport_itr]->vc_isEmpty(in_vc) == false)
-                flit_ = router->get_inputUnit_ref()[inport_itr]->peekTopFlit(in_vc);
-            else
-                bail_out[inport_itr][in_vc] = -1; // mark the given entry in vec as empty
-
-            if (flit_ != NULL) {
-                // cout << *flit_ << endl;
-                // we are successfully able to peek the flit of upstream router
-                // assert(flit_->get_vnet() == 0);
-                PortDirection outport_dir = flit_->get_outport_dir();
-                if(outport_dir == "Local") // Exceptional case
-                    return false; // we don't need to bail-out as this flit is going to be ejected
-                downstreamId = get_downstreamId(outport_dir, my_id);
-                downstreamInportDirn = get_downstreamDirn(outport_dir);
-                assert(downstreamInportDirn != "Local");
-                downstreamInportId = m_routers[downstreamId]->get_routingUnit_ref()\
-                                            ->m_inports_dirn2idx[downstreamInportDirn];
-                int vc;
-                for(vc = vc_base; vc < vc_base + m_vcs_per_vnet; vc++) {
-                    if ((m_routers[downstreamId]->is_swap == true) &&
-                        (m_routers[downstreamId]->get_inputUnit_ref()[downstreamInportId]\
-                                                ->vc_isEmpty(vc) == false))
-                        continue;
-                    else
-                        break; // either `is_swap` is false or vc is empty (don't bailOut)
-                }
-                if (vc == (vc_base + m_vcs_per_vnet))
-                    bail_out[inport_itr][in_vc] = 1; // need to bail_out
-                else
-                    bail_out[inport_itr][in_vc] = 7; // don't bail_out
+    flit* flit_ = router->get_inputUnit_ref()[router->swap_ptr.inport]->
+        peekTopFlit(router->swap_ptr.vcid);
+    OutputUnit *output_unit =
+        router->get_outputUnit_ref()[flit_->get_outport()];
+    int downstream_id = output_unit->get_downstream_router();
+    if (downstream_id == -1)
+        return false; // going to be ejected
 
-            } else {
-                assert(bail_out[inport_itr][in_vc] == -1); // empty inport at upstream rout
-            }
-        }
+    Router* dnstream_router = m_routers[downstream_id];
+    InputUnit *input_unit = dnstream_router->get_inputUnit_ref()[
+        output_unit->get_downstream_inport()];
+    int vc_base = vnet * m_vcs_per_vnet;
+    for (int vc = vc_base; vc < vc_base + m_vcs_per_vnet; vc++) {
+        if (input_unit->vc_isEmpty(vc))
+            return false;
     }
-    #if (MY_PRINT)
-        cout << "bail_out Matrix for router: " << my_id << endl;
-        for (int inport=0; inport < num_inports; ++inport) {
-            cout << endl;
-            for (int in_vc = 0; in_vc < vcs_per_vnet; ++in_vc) {
-                cout << bail_out[inport][in_vc] << "\t";
-            }
-        }
-
-        cout << endl;
-    #endif
 
-    // Sanity check: no entry should be 0
-    for (int inport=0; inport < num_inports; ++inport)
-        for (int in_vc = 0; in_vc < vcs_per_vnet; ++in_vc)
-            assert(bail_out[inport][in_vc] != 0);
-
-    //---------<bail-out matrix analysis>----------
-    // bail_out Matrix must be filled completely with entry != 0
-    // 1. do the analysis here on the vector
-    // if no need to bail_out:
-    // update the swap_ptr(inport+dirn) so that swap can happen; ret false
-    for (int inport=0; inport < num_inports; ++inport) {
-        for (int in_vc = 0; in_vc < vcs_per_vnet; ++in_vc) {
-            assert(bail_out[inport][in_vc] != 0);
-            if (bail_out[inport][in_vc] == 7) {
-
-                if ((router->get_inputUnit_ref()[inport]->vc_isEmpty(in_vc) == false) &&
-                    (router->getInportDirection(inport) != "Local")) {
-                    router->swap_ptr.inport = inport;
-                    router->swap_ptr.inport_dirn = router\
-                    ->get_inputUnit_ref()[router->swap_ptr.inport]->get_direction();
-                    router->swap_ptr.vcid = in_vc; // because we are making sure vcid0 is not empty
-                }
-                return false; // this will return wo completing the loop
-           }
-        }
-    }
-    if (router->is_swap == true)
-        return true;
-    else
-        return false;
+    return router->is_swap && dnstream_router->is_swap;
 }
 
 void
-GarnetNetwork::bail_out(int my_id)
+GarnetNetwork::bail_out(int my_id, int vnet)
 {
     // if this sequence is being called then current swap_ptr direction and [inport_id-vc_id]
     // should not be empty and the pointed outport of downstream routed should also
@@ -664,19 +599,19 @@ GarnetNetwork::bail_out(int my_id)
     assert((upstreamInport != -1) && (upstreamVcId != -1));
     assert(router->get_inputUnit_ref()[upstreamInport]->vc_isEmpty(upstreamVcId) == false);
     flit* flit_ = router->get_inputUnit_ref()[upstreamInport]->peekTopFlit(upstreamVcId);
-    PortDirection outport_dir = flit_->get_outport_dir();
-    int downstream_id = get_downstreamId(outport_dir, my_id);
+    OutputUnit *output_unit =
+        router->get_outputUnit_ref()[flit_->get_outport()];
+    int downstream_id = output_unit->get_downstream_router();
+    assert(downstream_id != -1);
     Router* dnstream_router = m_routers[downstream_id];
     assert(vcs_per_vnet == dnstream_router->get_vc_per_vnet());
-    // inport direction of downstream router
-    PortDirection inport_dirn = get_downstreamDirn(outport_dir);
-    assert(inport_dirn != "Local");
-    int downstream_inport_id =
-        dnstream_router->get_routingUnit_ref()->m_inports_dirn2idx[inport_dirn];
+    int downstream_inport_id = output_unit->get_downstream_inport();
     // assert(dnstream_router->is_swap == true);
     // assert(router->is_swap == true);
 
-    for (int in_vc = 0; in_vc < vcs_per_vnet; ++in_vc)
+    // the symptom was checked in the candidate's vnet
+    int vc_base = vnet*vcs_per_vnet;
+    for (int in_vc = vc_base; in_vc < vc_base + vcs_per_vnet; ++in_vc)
         assert(dnstream_router->get_inputUnit_ref()[downstream_inport_id]\
             ->vc_isEmpty(in_vc) == false);
 
@@ -686,11 +621,8 @@ GarnetNetwork::bail_out(int my_id)
     m_routers[my_id]->is_swap = false;
     m_routers[downstream_id]->is_swap = false;
     // clear the routedSwap from upstream router.
-    // int vcs_per_vnet = router->get_vc_per_vnet();
-    int vnet = 0;
-    int vc_base = vnet*vcs_per_vnet;
     for (int inport = 0; inport < router->get_num_inports(); inport++) {
-        for (int vc = vc_base; vc < vc_base + m_vcs_per_vnet; vc++) {
+        for (int vc = vc_base; vc < vc_base + vcs_per_vnet; vc++) {
             if(router->get_inputUnit_ref()[inport]->vc_isEmpty(vc))
                 continue;
             else {
@@ -702,7 +634,7 @@ GarnetNetwork::bail_out(int my_id)
     }
     // clear the routedSwap from dnstream router.
     for (int inport = 0; inport < dnstream_router->get_num_inports(); inport++) {
-        for (int vc = vc_base; vc < vc_base + m_vcs_per_vnet; vc++) {
+        for (int vc = vc_base; vc < vc_base + vcs_per_vnet; vc++) {
             if(dnstream_router->get_inputUnit_ref()[inport]->vc_isEmpty(vc))
                 continue; //. shouldn't be empty though...
             else {
@@ -725,18 +657,21 @@ GarnetNetwork::doSwap(flit *flit_t, int upstream_id)
         cout << "GarnetNetwork::doSwap()" << endl;
     #endif
 
-	int downstream_id = -1;
-    PortDirection inport_dirn = "Unknown";
-	/*outport direction from the flit for this router*/
-	PortDirection outport_dir = flit_t->get_outport_dir();
     #if (MY_PRINT)
-        cout << "Head-flit's outport_dir: " <<  outport_dir << endl;
+        cout << "Head-flit's outport_dir: " << flit_t->get_outport_dir()
+             << endl;
         cout <<  "Head-flit's outport: " << flit_t->get_outport() << endl;
     #endif
 
-    downstream_id = get_downstreamId(outport_dir, upstream_id);
-    // inport dirn at (wrt) downstream router
-    inport_dirn = get_downstreamDirn(outport_dir);
+    // the router and inport behind the flit's outport, from the link
+    // table; works for any link, including the chiplet boundaries
+    OutputUnit *output_unit =
+        m_routers[upstream_id]->get_outputUnit_ref()[flit_t->get_outport()];
+    int downstream_id = output_unit->get_downstream_router();
+    if (downstream_id == -1)
+        return NULL; // going to be ejected
+    // inport at (wrt) downstream router
+    int inport = output_unit->get_downstream_inport();
 	// Only do swap when is_swap bit is low
 	// after doing the swap set it high at
 	// downstream router...
@@ -746,12 +681,12 @@ GarnetNetwork::doSwap(flit *flit_t, int upstream_id)
         if ((m_routers[downstream_id]->is_swap == false) &&
             (m_routers[downstream_id]->swap_ptr.valid == true)) {
             // get the flit from downstream router..
-            // this 'inport_dirn' is of downstream router
+            // this 'inport' is of downstream router
             // we do swap with *SAME* vcid of the downstream router as indicated by
             // the swap_ptr of upstream router...
             int vcid = m_routers[upstream_id]->swap_ptr.vcid;
             assert(vcid == flit_t->get_vc());
-            flit* flit1_t = m_routers[downstream_id]->doSwap(inport_dirn, vcid);
+            flit* flit1_t = m_routers[downstream_id]->doSwap(inport, vcid);
             if (flit1_t == NULL) {
                 // this means that queue at downstream router is empty OR
                 // mis-routed flit has Local outport
@@ -777,7 +712,7 @@ GarnetNetwork::doSwap(flit *flit_t, int upstream_id)
                     cout << "GarnetNetwork::doSwap upstream_id: " << upstream_id << endl;
                     cout << "GarnetNetwork::doSwap downstream_id: " << downstream_id << endl;
                 #endif
-                m_routers[downstream_id]->doSwap_enqueue(flit_t, inport_dirn, -1, vcid);
+                m_routers[downstream_id]->doSwap_enqueue(flit_t, inport, vcid, true);
                 return flit1_t;
             }
         }
@@ -792,7 +727,7 @@ GarnetNetwork::doSwap(flit *flit_t, int upstream_id)
             int vcid = m_routers[upstream_id]->swap_ptr.vcid;
             assert(vcid == flit_t->get_vc());
             flit* flit1_t = m_routers[downstream_id]->\
-                            doSwap(inport_dirn, vcid);
+                            doSwap(inport, vcid);
             if (flit1_t == NULL) {
                 #if (MY_PRINT)
                 cout << "SWAP failed because downstream router did not return SWAP-back flit" << endl;
@@ -821,7 +756,7 @@ GarnetNetwork::doSwap(flit *flit_t, int upstream_id)
                             << downstream_id << endl;
                 #endif
                 m_routers[downstream_id]->\
-                            doSwap_enqueue(flit_t, inport_dirn, -1, vcid);
+                            doSwap_enqueue(flit_t, inport, vcid, true);
                 return flit1_t;
             }
         }
@@ -887,7 +822,7 @@ GarnetNetwork::scanNetwork()
         cout << "Router_id: " << router->get_id() << " Cycle: " << curCycle() << endl;
         for (int outport = 0; outport < router->get_num_outports(); outport++) {
             // print here the outport ID and flit in that outport Link...
-            PortDirection direction_ = router->get_outputUnit_ref()[outport]\
+            PortDirn direction_ = router->get_outputUnit_ref()[outport]\
                                                                 ->get_direction();
             // cout << "outport: " << outport << " direction: " << direction_ << endl;
             assert(outport == router->get_outputUnit_ref()[outport]->get_id());
@@ -910,57 +845,6 @@ GarnetNetwork::scanNetwork()
     return;
 }
 
-int
-GarnetNetwork::get_upstreamId( PortDirection inport_dir, int my_id )
-{
-    int num_cols = getNumCols();
-    int upstream_id = -1; // router_id for downstream router
-    /*outport direction fromt he flit for this router*/
-    if (inport_dir == "East") {
-        upstream_id = my_id + 1;
-    }
-    else if (inport_dir == "West") {
-        upstream_id = my_id - 1;
-    }
-    else if (inport_dir == "North") {
-        upstream_id = my_id + num_cols;
-    }
-    else if (inport_dir == "South") {
-        upstream_id = my_id - num_cols;
-    }
-    else if (inport_dir == "Local") {
-        upstream_id = my_id;
-        #if (MY_PRINT)
-            cout << "inport_dir: " << inport_dir << endl;
-        #endif
-        // assert(0);
-        // return -1;
-    }
-    else {
-        #if (MY_PRINT)
-            cout << "inport_dir: " << inport_dir << endl;
-        #endif
-        assert(0); // for completion of if-else chain
-        return -1;
-    }
-
-    return upstream_id;
-}
-
-//TODO: Possible router id check to handle swap in interposer
-Router*
-GarnetNetwork::get_upstreamrouter(PortDirection inport_dir, int upstream_id)
-{
-    int router_id = -1;
-    router_id = get_upstreamId( inport_dir, upstream_id);
-//    cout << "downstream router-id: " << router_id << endl;
-    // assert(router_id >= 0);
-    if ((router_id < 0) || (router_id >= getNumRouters()))
-        return NULL;
-    else
-        return m_routers[router_id];
-}
-
 void
 GarnetNetwork::regStats()
 {
@@ -972,6 +856,71 @@ GarnetNetwork::regStats()
     total_post_swap_deadlock
         .name(name() + ".total_post_swap_deadlock");
 
+    // Chiplet boundaries
+    int num_boundaries = m_chiplet_layout.numBoundaries();
+    if (num_boundaries > 0) {
+        m_boundary_egress_packets
+            .init(num_boundaries)
+            .name(name() + ".boundary_egress_packets")
+            .flags(Stats::pdf | Stats::total | Stats::oneline)
+            ;
+        m_boundary_ingress_packets
+            .init(num_boundaries)
+            .name(name() + ".boundary_ingress_packets")
+            .flags(Stats::pdf | Stats::total | Stats::oneline)
+            ;
+        // named <chiplet router>-<interposer router>
+        for (int region = 0; region < m_chiplet_layout.numRegions();
+             region++) {
+            for (int i = 0; i < m_chiplet_layout.numBoundaries(region);
+                 i++) {
+                const ChipletLayout::Boundary &b =
+                    m_chiplet_layout.boundary(region, i);
+                std::string link = csprintf("%d-%d", b.router,
+                                            b.interposer_router);
+                m_boundary_egress_packets.subname(b.index, link);
+                m_boundary_ingress_packets.subname(b.index, link);
+            }
+        }
+    }
+
+    // Congestion sideband: values and bits sent over its links
+    m_sideband_updates
+        .name(name() + ".sideband_updates");
+    m_sideband_bits
+        .name(name() + ".sideband_bits");
+
+    // Wait-for graph deadlock detection
+    m_deadlock_checks
+        .name(name() + ".deadlock_checks");
+    m_deadlocks
+        .name(name() + ".deadlocks");
+    m_deadlocked_vcs
+        .name(name() + ".deadlocked_vcs");
+    m_deadlock_ring_length
+        .name(name() + ".deadlock_ring_length");
+    m_deadlocked_cycles
+        .name(name() + ".deadlocked_cycles");
+    m_deadlock_recoveries
+        .name(name() + ".deadlock_recoveries");
+    m_deadlock_recovery_latency
+        .name(name() + ".deadlock_recovery_latency");
+    m_avg_deadlock_recovery_latency
+        .name(name() + ".average_deadlock_recovery_latency");
+    m_avg_deadlock_recovery_latency =
+        m_deadlock_recovery_latency / m_deadlock_recoveries;
+
+    // Deadlock rotation
+    m_rotations
+        .name(name() + ".rotations");
+    m_rotated_flits
+        .name(name() + ".rotated_flits");
+    m_avg_rotation_ring_length
+        .name(name() + ".average_rotation_ring_length");
+    m_avg_rotation_ring_length = m_rotated_flits / m_rotations;
+    m_skipped_rotations
+        .name(name() + ".skipped_rotations");
+
     // Packets
     m_packets_received
         .init(m_virtual_networks)
@@ -1155,6 +1104,12 @@ GarnetNetwork::regStats()
         .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
         ;
 
+    // Flit pool
+    m_peak_live_flits
+        .name(name() + ".peak_live_flits");
+    m_flit_pool_slabs
+        .name(name() + ".flit_pool_slabs");
+
     //interSwap related stats
     m_total_swaps
         .name(name() + ".total_swaps");
@@ -1166,6 +1121,10 @@ GarnetNetwork::regStats()
         .name(name() + ".m_total_initiated_swaps");
     m_total_failed_swaps
         .name(name() + ".m_total_failed_swaps");
+    m_total_blocked_swaps
+        .name(name() + ".total_blocked_swaps");
+    m_total_skipped_swaps
+        .name(name() + ".total_skipped_swaps");
     m_total_failed_downstream_empty
         .name(name() + ".m_total_failed_downstream_empty");
     m_total_failed_upstream_empty
@@ -1213,6 +1172,9 @@ GarnetNetwork::collateStats()
     for (int i = 0; i < m_routers.size(); i++) {
         m_routers[i]->collateStats();
     }
+
+    m_peak_live_flits = m_flit_pool.get_peak_live();
+    m_flit_pool_slabs = m_flit_pool.get_num_slabs();
 }
 
 void
@@ -42,7 +42,12 @@
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
+#include "mem/ruby/network/garnet2.0/ChipletLayout.hh"
+#include "mem/ruby/network/garnet2.0/CongestionSideband.hh"
+#include "mem/ruby/network/garnet2.0/WaitForGraph.hh"
+#include "mem/ruby/network/garnet2.0/TurnModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/flitPool.hh"
 #include "params/GarnetNetwork.hh"
 
 class FaultModel;
@@ -80,6 +85,15 @@ public:
     uint32_t getBuffersPerDataVC() { return m_buffers_per_data_vc; }
     uint32_t getBuffersPerCtrlVC() { return m_buffers_per_ctrl_vc; }
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
+    SwitchAllocatorType getSwitchAllocator() const
+    { return m_switch_allocator; }
+    RoutingVariant getRoutingVariant() const { return m_routing_variant; }
+    const ChipletLayout &getChipletLayout() const
+    { return m_chiplet_layout; }
+    // indexed by router id, filled in init()
+    const std::vector<RouterCoord> &getRouterCoords() const
+    { return m_router_coords; }
+    const TurnModel &getTurnModel() const { return m_turn_model; }
 
     //SWAP_GARNET_2.0_MERGE
     // interSwap congfig.
@@ -101,10 +115,66 @@ public:
     }
     int getNumRouters();
     int get_router_id(int ni);
+    Router *getRouter(int router_id) { return m_routers[router_id]; }
+
+    BoundarySelection getBoundarySelection() const
+    { return m_boundary_selection; }
+    // Fix the route's chiplet boundaries (CUSTOM_ routing only)
+    void selectBoundaries(RouteInfo &route);
+    InterposerIntermediate getInterposerIntermediate() const
+    { return m_interposer_intermediate; }
+    // Pick the route's interposer intermediate, after its boundaries
+    void selectIntermediate(RouteInfo &route);
+    void increment_boundary_egress(int boundary)
+    { m_boundary_egress_packets[boundary]++; }
+    void increment_boundary_ingress(int boundary)
+    { m_boundary_ingress_packets[boundary]++; }
+
+    // Regional congestion sideband, NULL unless a period is set
+    const CongestionSideband *getCongestionSideband() const
+    { return m_congestion_sideband; }
+    void increment_sideband_updates(int updates, int bits)
+    {
+        m_sideband_updates += updates;
+        m_sideband_bits += bits;
+    }
 
-    //SWAP_GARNET_2.0_MERGE
-    int get_upstreamId(PortDirection outport_dir, int upstream_id);
-    Router* get_upstreamrouter(PortDirection outport_dir, int upstream_id);
+    // Wait-for graph deadlock detector, NULL unless a period is set
+    WaitForGraph *getWaitForGraph() { return m_wait_for_graph; }
+    void increment_deadlock_checks() { m_deadlock_checks++; }
+    void increment_deadlocks(int vcs, int ring_length)
+    {
+        m_deadlocks++;
+        m_deadlocked_vcs += vcs;
+        m_deadlock_ring_length += ring_length;
+    }
+    void increment_deadlocked_cycles(int cycles)
+    { m_deadlocked_cycles += cycles; }
+    void increment_deadlock_recoveries(int latency)
+    {
+        m_deadlock_recoveries++;
+        m_deadlock_recovery_latency += latency;
+    }
+    void increment_rotations(int ring_length)
+    {
+        m_rotations++;
+        m_rotated_flits += ring_length;
+    }
+    void increment_skipped_rotations() { m_skipped_rotations++; }
+
+    // Source routing: the NI fills in the whole path of a flit by
+    // running each router's routing on it
+    bool isSourceRouting() const { return m_source_routing; }
+    void computeSourceRoute(RouteInfo &route, int vc);
+    const SourceRoute &getSourceRoute(int path_id) const
+    { return m_source_routes[path_id]; }
+    // once the tail flit of the packet is ejected
+    void
+    releaseSourceRoute(const RouteInfo &route)
+    {
+        if (route.path_id != -1)
+            m_free_source_routes.push_back(route.path_id);
+    }
 
 
     // Methods used by Topology to setup the network
@@ -171,6 +241,9 @@ public:
             }
     }
 
+    // flits are allocated from and returned to the network-wide pool
+    flitPool *getFlitPool() { return &m_flit_pool; }
+
     void increment_injected_packets(int vnet) { m_packets_injected[vnet]++; }
     void increment_received_packets(int vnet) { m_packets_received[vnet]++; }
 
@@ -230,20 +303,15 @@ public:
 	flit*
 	doSwap(flit *t_flit, int upstream_id);
 
-    int
-    get_downstreamId(PortDirection outport_dir, int upstream_id);
-
-    PortDirection
-    get_downstreamDirn(PortDirection outport_dir);
-
-    Router*
-    get_downstreamRouter(PortDirection outport_dir, int upstream_id);
-
     bool
     chk_deadlck_symptm(int my_id, int vnet);
 
     void
-    bail_out(int my_id);
+    bail_out(int my_id, int vnet);
+
+    // see GarnetNetwork.py
+    uint32_t getSwapBlockedThreshold() const
+    { return m_swap_blocked_threshold; }
 
     inline uint32_t
     get_whenToSwap() {
@@ -260,6 +328,10 @@ public:
     Stats::Scalar m_total_bailout; //sanitized
     Stats::Scalar m_total_routedSwaps;
     Stats::Scalar m_total_initiated_swaps; // sanitized
+    // initiated with a blocked candidate / turns skipped as it was not
+    // blocked for swap_blocked_threshold cycles
+    Stats::Scalar m_total_blocked_swaps;
+    Stats::Scalar m_total_skipped_swaps;
     Stats::Scalar m_total_failed_swaps; // sanitized
     Stats::Scalar m_total_failed_downstream_empty;
     Stats::Scalar m_total_failed_upstream_empty;
@@ -311,6 +383,21 @@ protected:
     uint32_t m_buffers_per_ctrl_vc;
     uint32_t m_buffers_per_data_vc;
     int m_routing_algorithm;
+    SwitchAllocatorType m_switch_allocator;
+    RoutingVariant m_routing_variant;
+    bool m_source_routing;
+    // pool of the paths of source routed packets in flight
+    std::vector<SourceRoute> m_source_routes;
+    std::vector<int> m_free_source_routes;
+    BoundarySelection m_boundary_selection;
+    InterposerIntermediate m_interposer_intermediate;
+    ChipletLayout m_chiplet_layout;
+    std::vector<RouterCoord> m_router_coords;
+    std::string m_turn_model_name;
+    std::vector<std::string> m_turn_model_prohibited;
+    TurnModel m_turn_model;
+    CongestionSideband *m_congestion_sideband;
+    WaitForGraph *m_wait_for_graph;
     bool m_enable_fault_model;
 
     // don't be lazy make interSwap dataVariable
@@ -318,8 +405,33 @@ protected:
 	uint32_t m_policy;
 	bool m_interswap;
     uint32_t m_whenToSwap;
+    uint32_t m_swap_blocked_threshold;
 
     // Statistical variables
+    // packets sent down / up each boundary link of the chiplet layout
+    Stats::Vector m_boundary_egress_packets;
+    Stats::Vector m_boundary_ingress_packets;
+    // overhead of the congestion sideband: values sent and wire bits
+    Stats::Scalar m_sideband_updates;
+    Stats::Scalar m_sideband_bits;
+    // wait-for graph checks, deadlocks found, the VCs and the length of
+    // the traced cycle summed over them, and cycles spent deadlocked
+    Stats::Scalar m_deadlock_checks;
+    Stats::Scalar m_deadlocks;
+    Stats::Scalar m_deadlocked_vcs;
+    Stats::Scalar m_deadlock_ring_length;
+    Stats::Scalar m_deadlocked_cycles;
+    // deadlocks gone at a later check, and the cycles since they were
+    // found; rotations, the flits they moved, and rings that could not
+    // be rotated
+    Stats::Scalar m_deadlock_recoveries;
+    Stats::Scalar m_deadlock_recovery_latency;
+    Stats::Formula m_avg_deadlock_recovery_latency;
+    Stats::Scalar m_rotations;
+    Stats::Scalar m_rotated_flits;
+    Stats::Formula m_avg_rotation_ring_length;
+    Stats::Scalar m_skipped_rotations;
+
     Stats::Vector m_packets_received;
     Stats::Vector m_packets_injected;
     Stats::Vector m_packet_network_latency;
@@ -353,6 +465,10 @@ protected:
 
     Stats::Scalar  m_total_hops;
     Stats::Formula m_avg_hops;
+
+    // flit pool
+    Stats::Scalar m_peak_live_flits;
+    Stats::Scalar m_flit_pool_slabs;
     // for detecting deadlock periodically
     //double last_probe;
 
@@ -365,6 +481,8 @@ private:
     std::vector<NetworkLink*> m_networklinks; // All flit links in the network
     std::vector<CreditLink*> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface*> m_nis;   // All NI's in Network
+
+    flitPool m_flit_pool;
 };
 
 inline std::ostream&
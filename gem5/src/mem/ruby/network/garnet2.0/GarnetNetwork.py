@@ -43,18 +43,80 @@ class GarnetNetwork(RubyNetwork):
     # ';' in python!
 	# interSwap parameters
     interswap = Param.UInt32(0, "To enable interswap")
-    whenToSwap = Param.UInt32(0, "when interswap enabled should we swap on TDM/2*TDM/etc")
+    whenToSwap = Param.UInt32(0, "when interswap enabled: swap turn period, in multiples of the number of routers (1: TDM, 2: 2*TDM, ...)")
     whichToSwap = Param.UInt32(0, "Should Local ports take part in Swapping etc")
     policy = Param.UInt32(0, "Policy to be used applicable when interswap is 1")
+    swap_blocked_threshold = Param.UInt32(0, "cycles the swap candidate must have waited for a VC of its outport before a swap is initiated; 0 swaps on every turn")
 	######################
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
+        "0: Weight-based Table, 1: XY, 2: Turn Model Oblivious, "
+        "3: Turn Model Adaptive, 4: Random Oblivious, "
+        "5: Random Adaptive (escape VC), 6: Custom");
+    switch_allocator = Param.UInt32(0,
+        "0: loop-based SA, 1: bitmask SA, "
+        "2: run both and panic on any grant mismatch");
+    routing_variant = Param.UInt32(0,
+        "chiplet routing variant: 0: iswap, 1: deadlock_check, "
+        "2: composable, 3: bp, 4: wrkn, "
+        "5: duato (adaptive with an XY escape VC)");
+    turn_model = Param.String("north_last",
+        "turn model of routing algorithms 2 and 3: west_first, "
+        "north_last, negative_first, odd_even or custom");
+    turn_model_prohibited = VectorParam.String([],
+        "prohibited turns of the custom turn model, as <from><to> travel "
+        "directions (e.g. NW), optionally prefixed with even: or odd: "
+        "to apply to those columns only");
+    boundary_selection = Param.UInt32(0,
+        "boundary routers of chiplet routing: 0: static hash, "
+        "1: least loaded, 2: power of two choices");
+    congestion_sideband_period = Param.UInt32(0,
+        "cycles between regional congestion updates sent to the "
+        "neighbor routers, for the adaptive routing; 0 disables them");
+    congestion_sideband_latency = Param.UInt32(1,
+        "cycles a congestion update takes to reach the neighbor, "
+        "rounded up to whole update periods");
+    congestion_sideband_weight = Param.UInt32(50,
+        "percent weight of the local outport occupancy against the "
+        "congestion received from the neighbor");
+    congestion_sideband_bits = Param.UInt32(4,
+        "width of a congestion value on the sideband links");
+    deadlock_detect_period = Param.UInt32(0,
+        "cycles between checks of the channel wait-for graph for "
+        "deadlocks; 0 disables it and leaves detection to the NIs");
+    deadlock_rotation = Param.Bool(False,
+        "resolve each deadlock found by the wait-for graph by moving "
+        "every flit of one of its cycles a hop forward at once");
+    rotation_latency = Param.UInt32(1,
+        "cycles the flits moved by a rotation are held, its modeled cost");
+    interposer_intermediate = Param.UInt32(0,
+        "two-phase oblivious routing across the interposer (custom "
+        "routing): 0: off, 1: Valiant, random intermediate router, "
+        "2: ROMM, random intermediate in the minimal quadrant");
+    source_routing = Param.Bool(False,
+        "compute the whole route at the NI; oblivious routing only");
+    # Chiplet layout for the custom routing, filled in by the topology
+    # (see configs/topologies/Het_meshs.py). Routers are grouped in
+    # regions (chiplets and one interposer), each a mesh.
+    router_region = VectorParam.Int([], "region of each router");
+    router_x = VectorParam.Int([], "column of each router in its region");
+    router_y = VectorParam.Int([], "row of each router in its region");
+    interposer_region = Param.Int(-1, "region of the interposer");
+    boundary_routers = VectorParam.Int([],
+        "chiplet routers linked to the interposer");
+    boundary_interposer = VectorParam.Int([],
+        "interposer router linked to each boundary router");
+    boundary_down = VectorParam.String([],
+        "outport of each boundary router towards the interposer");
+    boundary_up = VectorParam.String([],
+        "outport of the interposer router towards each boundary router");
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
-                              "network-level deadlock threshold")
+                              "network-level deadlock threshold: cycles "
+                              "a deadlock found by the wait-for graph, or "
+                              "else an NI without a free VC, may last")
     enable_loupe = Param.Bool(False, "enable loupe, a deadlock visualization tool")
     loupe_tracing_threshold = Param.UInt32(0, "loupe logging threshold")
     no_is_swap = Param.UInt32(Parent.no_is_swap,
@@ -33,6 +33,8 @@
 
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 
+#include <algorithm>
+
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
@@ -42,7 +44,7 @@
 using namespace std;
 using m5::stl_helpers::deletePointers;
 
-InputUnit::InputUnit(int id, PortDirection direction, Router *router)
+InputUnit::InputUnit(int id, PortDirn direction, Router *router)
             : Consumer(router)
 {
     m_id = id;
@@ -50,6 +52,8 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
     m_vc_per_vnet = m_router->get_vc_per_vnet();
+    m_upstream_router = -1;
+    m_upstream_outport = -1;
 
     m_num_buffer_reads.resize(m_num_vcs/m_vc_per_vnet);
     m_num_buffer_writes.resize(m_num_vcs/m_vc_per_vnet);
@@ -58,17 +62,21 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
         m_num_buffer_writes[i] = 0;
     }
 
-    creditQueue = new flitBuffer();
     // Instantiating the virtual channels
     m_vcs.resize(m_num_vcs);
     for (int i=0; i < m_num_vcs; i++) {
         m_vcs[i] = new VirtualChannel(i);
     }
+
+    // one occupancy bit per VC
+    assert(m_num_vcs <= 64);
+    m_occupied_vcs = 0;
+    m_vc_ready_time.resize(m_num_vcs, NEVER_READY_);
+    m_earliest_ready = NEVER_READY_;
 }
 
 InputUnit::~InputUnit()
 {
-    delete creditQueue;
     deletePointers(m_vcs);
 }
 
@@ -91,6 +99,8 @@ InputUnit::wakeup()
         t_flit = m_in_link->consumeLink();
         int vc = t_flit->get_vc();
         t_flit->increment_hops(); // for stats
+        t_flit->advance_path();
+        t_flit->reach_router(m_router->get_id());
         #if (MY_PRINT)
             cout << "InputUnit::wakeup()--- m_id: " << m_id << endl;
             cout << "InputUnit::wakeup()--- direction: " << m_direction << endl;
@@ -114,10 +124,10 @@ InputUnit::wakeup()
             // the flit as well
             t_flit->set_outport(outport);
             // set the outport_dir as well
-            PortDirection outdir1; // Could this be buggy?
-            PortDirection outdir2;
+            PortDirn outdir1; // Could this be buggy?
+            PortDirn outdir2;
             outdir1 =
-                m_router->get_routingUnit_ref()->m_outports_idx2dirn[outport];
+                m_router->get_routingUnit_ref()->outportDirn(outport);
             outdir2 =
                 m_router->getOutportDirection(outport); // this sounds right!
             // sanity
@@ -141,6 +151,8 @@ InputUnit::wakeup()
 
         // Buffer the flit
         m_vcs[vc]->insertFlit(t_flit);
+        if (m_direction != LOCAL_DIRN_)
+            m_router->arm_swap_turn();
 
         int vnet = vc/m_vc_per_vnet;
         // number of writes same as reads
@@ -171,6 +183,7 @@ InputUnit::wakeup()
         // performing Switch Allocation
         Cycles wait_time = pipe_stages - Cycles(1);
         t_flit->advance_stage(SA_, m_router->curCycle() + wait_time);
+        update_vc_summary(vc);
 
         // Loupe
         GarnetNetwork* net_ptr = m_router->get_net_ptr();
@@ -225,19 +238,16 @@ InputUnit::makeSwapPtrValid(flit* t_flit) {
 
         // NOTE: Causing heavy perf-penatlty
         // we can also make swap_ptr point to Local Port if 'ENABLE_LOCAL_SWAP_' is true
-        if (((this->m_direction == "North") || (this->m_direction == "East") ||
-            (this->m_direction == "West") || (this->m_direction == "South")) &&
-            ((t_flit->get_outport_dir() == "North") ||
-             (t_flit->get_outport_dir() == "East") ||
-             (t_flit->get_outport_dir() == "West") ||
-             (t_flit->get_outport_dir() == "South")) &&
-             (get_router()->get_id() > 47)) { // ISWAP:checking router ID before setting swap pointer valid
+        // Any router-to-router link will do, chiplet boundaries included:
+        // swaps find the other end in the link tables.
+        if ((m_upstream_router != -1) &&
+            (t_flit->get_outport_dir() != LOCAL_DIRN_)) {
             // currently making swap_Ptr randomly valid;
             // in whichever inport dirn
             // flit comes first and taking from there to point to next inport
             // direction in SwitchAllocator stage
             //cout << "Router Id:" << get_router()->get_id() << endl;
-            get_router()->makeSwapPtrValid(this->m_direction, t_flit->get_vc());
+            get_router()->makeSwapPtrValid(m_id, t_flit->get_vc());
             // if you are making swap_ptr valid;
             // also specify direction.
             #if (MY_PRINT)
@@ -255,13 +265,39 @@ InputUnit::makeSwapPtrValid(flit* t_flit) {
 
 }
 
+// Refresh the occupancy bit and SA-ready cycle of one VC after its top
+// flit changed, then the inport-wide earliest ready cycle. Only the
+// occupied VCs are visited.
+void
+InputUnit::update_vc_summary(int vc)
+{
+    if (m_vcs[vc]->isEmpty()) {
+        m_occupied_vcs &= ~(1ULL << vc);
+        m_vc_ready_time[vc] = NEVER_READY_;
+    } else {
+        m_occupied_vcs |= (1ULL << vc);
+        // same condition as VirtualChannel::need_stage(SA_, t)
+        flit *t_flit = m_vcs[vc]->peekTopFlit();
+        if (t_flit->get_stage().first == SA_)
+            m_vc_ready_time[vc] = std::max(t_flit->get_time(),
+                                           t_flit->get_stage().second);
+        else
+            m_vc_ready_time[vc] = NEVER_READY_;
+    }
+
+    m_earliest_ready = NEVER_READY_;
+    for (uint64_t occ = m_occupied_vcs; occ; occ &= occ - 1) {
+        m_earliest_ready = std::min(m_earliest_ready,
+                                    m_vc_ready_time[findLsbSet(occ)]);
+    }
+}
+
 // Send a credit back to upstream router for this VC.
 // Called by SwitchAllocator when the flit in this VC wins the Switch.
 void
 InputUnit::increment_credit(int in_vc, bool free_signal, Cycles curTime)
 {
-    Credit *t_credit = new Credit(in_vc, free_signal, curTime);
-    creditQueue->insert(t_credit);
+    creditQueue.insert(Credit(in_vc, free_signal, curTime));
     m_credit_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
 }
 
@@ -307,7 +343,7 @@ void InputUnit::deadlockSnapshot() {
             deadlockFile << m_router->getOutportDirection(get_outport(i)) << ",";
             deadlockFile << m_router->curCycle() - t_flit->get_dequeue_time() << ",\n";
         }
-
+        update_vc_summary(i);
     }
     deadlockFile.close();
 }
@@ -37,6 +37,7 @@
 #include <iostream>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
@@ -48,7 +49,7 @@
 class InputUnit : public Consumer
 {
   public:
-    InputUnit(int id, PortDirection direction, Router *router);
+    InputUnit(int id, PortDirn direction, Router *router);
     ~InputUnit();
 
     void wakeup();
@@ -59,7 +60,7 @@ class InputUnit : public Consumer
     void makeSwapPtrValid(flit* t_flit);
     void print(std::ostream& out) const {};
 
-    inline PortDirection get_direction() { return m_direction; }
+    inline PortDirn get_direction() { return m_direction; }
     inline int get_id() { return m_id; }
 
     inline void
@@ -106,6 +107,12 @@ class InputUnit : public Consumer
 
     void increment_credit(int in_vc, bool free_signal, Cycles curTime);
 
+    inline int
+    get_vc_size(int vc)
+    {
+        return m_vcs[vc]->getSize();
+    }
+
     inline flit*
     peekTopFlit(int vc)
     {
@@ -115,7 +122,9 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return m_vcs[vc]->getTopFlit();
+        flit *t_flit = m_vcs[vc]->getTopFlit();
+        update_vc_summary(vc);
+        return t_flit;
     }
 
     inline bool
@@ -130,7 +139,7 @@ class InputUnit : public Consumer
         return m_vcs[invc]->isReady(curTime);
     }
 
-    flitBuffer* getCreditQueue() { return creditQueue; }
+    creditBuffer* getCreditQueue() { return &creditQueue; }
 
     inline void
     set_in_link(NetworkLink *link)
@@ -140,6 +149,17 @@ class InputUnit : public Consumer
 
     inline int get_inlink_id() { return m_in_link->get_id(); }
 
+    // Router and outport at the far end of the in link; -1 for links
+    // from a network interface
+    void
+    set_upstream(int router, int outport)
+    {
+        m_upstream_router = router;
+        m_upstream_outport = outport;
+    }
+    inline int get_upstream_router() { return m_upstream_router; }
+    inline int get_upstream_outport() { return m_upstream_outport; }
+
     inline void
     set_credit_link(CreditLink *credit_link)
     {
@@ -149,22 +169,22 @@ class InputUnit : public Consumer
     inline bool
     vc_isEmpty(int invc)
     {
-        return m_vcs[invc]->isEmpty();
+        return !(m_occupied_vcs & (1ULL << invc));
     }
 
+    // Bit i is set while input VC i holds at least one flit.
+    inline uint64_t get_occupied_vcs() const { return m_occupied_vcs; }
+
+    // Earliest cycle at which the top flit of any VC of this inport
+    // can take part in SA; NEVER_READY_ when the inport is empty.
+    inline Cycles get_earliest_ready() const { return m_earliest_ready; }
+
     inline int
-    get_numFreeVC(PortDirection dirn_)
+    get_numFreeVC(PortDirn dirn_)
     {
         assert(dirn_ == m_direction);
-        int freeVC = 0;
         // since we always use vnet=0
-        for (int vc_=0; vc_ < m_vc_per_vnet; ++vc_) {
-             if(m_vcs[vc_]->isEmpty() == true)
-                freeVC++;
-        }
-//        cout << "m_vc_per_vnet: " << m_vc_per_vnet << endl;
-//        cout << "freeVC: " << freeVC << endl;
-        return freeVC;
+        return m_vc_per_vnet - popCount(m_occupied_vcs & mask(m_vc_per_vnet));
     }
 
     void
@@ -173,6 +193,7 @@ class InputUnit : public Consumer
         // instead of tail; it should insert
         // flit at the head
         m_vcs[vc]->insertFlitAtTop(flit_t);
+        update_vc_summary(vc);
         return;
     }
 
@@ -191,16 +212,24 @@ class InputUnit : public Consumer
     std::vector<VirtualChannel *> m_vcs;
   private:
     int m_id;
-    PortDirection m_direction;
+    PortDirn m_direction;
     int m_num_vcs;
     int m_vc_per_vnet;
 
     Router *m_router;
     NetworkLink *m_in_link;
     CreditLink *m_credit_link;
-    flitBuffer *creditQueue;
+    int m_upstream_router;
+    int m_upstream_outport;
+    creditBuffer creditQueue;
+
+    // VC occupancy summary, kept in sync with every insert and pop
+    // so that wakeup, SA and the swap pointer only visit busy VCs.
+    uint64_t m_occupied_vcs;
+    std::vector<Cycles> m_vc_ready_time;
+    Cycles m_earliest_ready;
+    void update_vc_summary(int vc);
 
-    
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
@@ -58,11 +58,10 @@ NetworkInterface::NetworkInterface(const Params* p)
     m_vc_round_robin = 0;
     m_ni_out_vcs.resize(m_num_vcs);
     m_ni_out_vcs_enqueue_time.resize(m_num_vcs);
-    outCreditQueue = new flitBuffer();
 
     // instantiating the NI flit buffers
     for (int i = 0; i < m_num_vcs; i++) {
-        m_ni_out_vcs[i] = new flitBuffer();
+        m_ni_out_vcs[i] = new flitBuffer(FIFO_ORDER_);
         m_ni_out_vcs_enqueue_time[i] = Cycles(INFINITE_);
     }
 
@@ -86,7 +85,6 @@ NetworkInterface::~NetworkInterface()
 {
     deletePointers(m_out_vc_state);
     deletePointers(m_ni_out_vcs);
-    delete outCreditQueue;
     delete outFlitQueue;
 }
 
@@ -97,7 +95,7 @@ NetworkInterface::addInPort(NetworkLink* in_link,
     inNetLink = in_link;
     in_link->setLinkConsumer(this);
     outCreditLink = credit_link;
-    credit_link->setSourceQueue(outCreditQueue);
+    credit_link->setSourceQueue(&outCreditQueue);
 }
 
 void
@@ -109,7 +107,7 @@ NetworkInterface::addOutPort(NetworkLink* out_link,
     credit_link->setLinkConsumer(this);
 
     outNetLink = out_link;
-    outFlitQueue = new flitBuffer();
+    outFlitQueue = new flitBuffer(FIFO_ORDER_);
     out_link->setSourceQueue(outFlitQueue);
 
     m_router_id = router_id;
@@ -240,9 +238,10 @@ NetworkInterface::wakeup()
                 // this flit in the NI
                 sendCredit(t_flit, true);
 
-                // Update stats and delete flit pointer
+                // Update stats and return the flit to the pool
                 incrementStats(t_flit);
-                delete t_flit;
+                m_net_ptr->releaseSourceRoute(t_flit->get_route());
+                m_net_ptr->getFlitPool()->release(t_flit);
             }
             else {
                 // No space available- Place tail flit in stall queue and set
@@ -259,21 +258,20 @@ NetworkInterface::wakeup()
             // Non-tail flit. Send back a credit but not VC free signal.
             sendCredit(t_flit, false);
 
-            // Update stats and delete flit pointer.
+            // Update stats and return the flit to the pool.
             incrementStats(t_flit);
-            delete t_flit;
+            m_net_ptr->getFlitPool()->release(t_flit);
         }
     }
 
     /****************** Check the incoming credit link *******/
 
     if (inCreditLink->isReady(curCycle())) {
-        Credit* t_credit = (Credit*)inCreditLink->consumeLink();
-        m_out_vc_state[t_credit->get_vc()]->increment_credit();
-        if (t_credit->is_free_signal()) {
-            m_out_vc_state[t_credit->get_vc()]->setState(IDLE_, curCycle());
+        Credit t_credit = inCreditLink->consumeLink();
+        m_out_vc_state[t_credit.get_vc()]->increment_credit();
+        if (t_credit.is_free_signal()) {
+            m_out_vc_state[t_credit.get_vc()]->setState(IDLE_, curCycle());
         }
-        delete t_credit;
     }
 
 
@@ -281,7 +279,7 @@ NetworkInterface::wakeup()
     // was unstalled in the same cycle as a new message arrives. In this
     // case, we should schedule another wakeup to ensure the credit is sent
     // back.
-    if (outCreditQueue->getSize() > 0) {
+    if (outCreditQueue.getSize() > 0) {
         outCreditLink->scheduleEventAbsolute(clockEdge(Cycles(1)));
     }
 }
@@ -289,8 +287,7 @@ NetworkInterface::wakeup()
 void
 NetworkInterface::sendCredit(flit* t_flit, bool is_free)
 {
-    Credit* credit_flit = new Credit(t_flit->get_vc(), is_free, curCycle());
-    outCreditQueue->insert(credit_flit);
+    outCreditQueue.insert(Credit(t_flit->get_vc(), is_free, curCycle()));
 }
 
 bool
@@ -317,8 +314,9 @@ NetworkInterface::checkStallQueue()
                 // Update Stats
                 incrementStats(stallFlit);
 
-                // Flit can now safely be deleted and removed from stall queue
-                delete stallFlit;
+                // Flit can now safely be released and removed from stall queue
+                m_net_ptr->releaseSourceRoute(stallFlit->get_route());
+                m_net_ptr->getFlitPool()->release(stallFlit);
                 m_stall_queue.erase(stallIter);
                 m_stall_count[vnet]--;
 
@@ -400,11 +398,10 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         }
 
         // Embed Route into the flits
-        // NetDest format is used by the routing table
-        // Custom routing algorithms just need destID
+        // Both the routing table and custom routing algorithms
+        // just need destID
         RouteInfo route;
         route.vnet = vnet;
-        route.net_dest = new_net_msg_ptr->getDestination();
         route.src_ni = m_id;
         route.src_router = m_router_id;
         route.dest_ni = destID;
@@ -414,6 +411,14 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         // so that the first router increments it to 0
         route.hops_traversed = -1;
 
+        m_net_ptr->selectBoundaries(route);
+        m_net_ptr->selectIntermediate(route);
+
+        route.path_id = -1;
+        route.path_hop = -1;
+        if (m_net_ptr->isSourceRouting())
+            m_net_ptr->computeSourceRoute(route, vc);
+
         m_net_ptr->increment_injected_packets(vnet);
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
@@ -423,7 +428,8 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
             int id = curCycle() << 16;
             id += (m_router_id % 256) << 8;
             id += i;
-            flit* fl = new flit(id, vc, vnet, route, num_flits, new_msg_ptr, curCycle());
+            flit* fl = m_net_ptr->getFlitPool()->allocate(id, vc, vnet, route,
+                num_flits, new_msg_ptr, curCycle());
 
             fl->set_src_delay(curCycle() - ticksToCycles(msg_ptr->getTime()));
             m_ni_out_vcs[vc]->insert(fl);
@@ -464,6 +470,11 @@ NetworkInterface::calculateVC(int vnet)
 
     vc_busy_counter[vnet] += 1;
 
+    // The wait-for graph, when on, reports deadlocks with their ring;
+    // an NI starved for long is not one by itself
+    if (m_net_ptr->getWaitForGraph() != NULL)
+        return -1;
+
     if (vc_busy_counter[vnet] > m_deadlock_threshold) {
         // if above threshold, initiate deadlock debug process.
         m_net_ptr->deadlockSnapshot();
@@ -83,7 +83,7 @@ class NetworkInterface : public ClockedObject, public Consumer
     std::vector<int> m_vc_allocator;
     int m_vc_round_robin; // For round robin scheduling
     flitBuffer *outFlitQueue; // For modeling link contention
-    flitBuffer *outCreditQueue;
+    creditBuffer outCreditQueue;
     int m_deadlock_threshold;
 
     NetworkLink *inNetLink;
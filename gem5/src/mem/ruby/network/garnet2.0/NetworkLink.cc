@@ -43,7 +43,7 @@ NetworkLink::NetworkLink(const Params *p)
     : ClockedObject(p), Consumer(this), 
       // Loupe
       // m_type(NUM_LINK_TYPES_),
-      linkBuffer(new flitBuffer()), 
+      linkBuffer(new flitBuffer(FIFO_ORDER_)),
       m_id(p->link_id),
       m_latency(p->link_latency),
       link_consumer(nullptr),
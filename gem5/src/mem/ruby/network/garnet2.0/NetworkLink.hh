@@ -84,7 +84,7 @@ class NetworkLink : public ClockedObject, public Consumer
     void resetStats();
 
   flitBuffer *linkBuffer;
-  private:
+  protected:
     const int m_id;
     // Loupe
     // link_type m_type;
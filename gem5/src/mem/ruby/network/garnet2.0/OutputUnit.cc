@@ -37,11 +37,12 @@
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
 
-OutputUnit::OutputUnit(int id, PortDirection direction, Router *router)
+OutputUnit::OutputUnit(int id, PortDirn direction, Router *router)
     : Consumer(router)
 {
     m_id = id;
@@ -49,11 +50,18 @@ OutputUnit::OutputUnit(int id, PortDirection direction, Router *router)
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
     m_vc_per_vnet = m_router->get_vc_per_vnet();
-    m_out_buffer = new flitBuffer();
+    m_out_buffer = new flitBuffer(FIFO_ORDER_);
+    m_downstream_router = -1;
+    m_downstream_inport = -1;
 
     for (int i = 0; i < m_num_vcs; i++) {
         m_outvc_state.push_back(new OutVcState(i, m_router->get_net_ptr()));
     }
+
+    // all output VCs start IDLE_, one bit per VC
+    assert(m_num_vcs <= 64);
+    m_idle_vcs = mask(m_num_vcs);
+    m_deferred_idle_vcs = 0;
 }
 
 OutputUnit::~OutputUnit()
@@ -92,54 +100,85 @@ OutputUnit::has_credit(int out_vc)
     return m_outvc_state[out_vc]->has_credit();
 }
 
-bool
-OutputUnit::has_free_vc(int vnet)
+void
+OutputUnit::set_vc_state(VC_state_type state, int vc, Cycles curTime)
+{
+    m_outvc_state[vc]->setState(state, curTime);
+
+    uint64_t vc_bit = 1ULL << vc;
+    if (state == IDLE_) {
+        m_idle_vcs |= vc_bit;
+        if (curTime > m_router->curCycle())
+            m_deferred_idle_vcs |= vc_bit;
+        else
+            m_deferred_idle_vcs &= ~vc_bit;
+    } else {
+        m_idle_vcs &= ~vc_bit;
+        m_deferred_idle_vcs &= ~vc_bit;
+    }
+}
+
+// Output VCs that are IDLE_ at curTime. Deferred transitions that
+// have come due are retired here, so the common case is one AND.
+uint64_t
+OutputUnit::idle_vcs(Cycles curTime)
 {
-    int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, m_router->curCycle()))
-            return true;
+    for (uint64_t deferred = m_deferred_idle_vcs; deferred;
+         deferred &= deferred - 1) {
+        int vc = findLsbSet(deferred);
+        if (m_outvc_state[vc]->isInState(IDLE_, curTime))
+            m_deferred_idle_vcs &= ~(1ULL << vc);
     }
 
-    return false;
+    return m_idle_vcs & ~m_deferred_idle_vcs;
+}
+
+bool
+OutputUnit::has_free_vc(int vnet)
+{
+    return (idle_vcs(m_router->curCycle()) & vnet_vcs(vnet)) != 0;
 }
 
 // Check if the output port (i.e., input port at next router) has free VCs.
 bool
 OutputUnit::has_free_vc(int vnet, int invc,
-         PortDirection inport_dirn, PortDirection outport_dirn, RouteInfo route)
+         PortDirn inport_dirn, PortDirn outport_dirn, const RouteInfo &route)
 {
-    // ICN Lab 3:
-    // Hint: invc, route, inport_dirn, outport_dirn are provided
-    // to implement escape VC
+    return allowed_vcs(vnet, outport_dirn, route) != 0;
+}
 
-    int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, m_router->curCycle()))
-            return true;
+// Free VCs of this vnet the flit may be allocated. With an escape VC,
+// it is only offered on the flit's XY outport, and last.
+uint64_t
+OutputUnit::allowed_vcs(int vnet, PortDirn outport_dirn,
+                        const RouteInfo &route)
+{
+    uint64_t free_vcs = idle_vcs(m_router->curCycle()) & vnet_vcs(vnet);
+
+    RoutingUnit *routing_unit = m_router->get_routingUnit_ref();
+    if (routing_unit->hasEscapeVC()) {
+        uint64_t escape_vc = routing_unit->escapeVC(vnet);
+        if ((free_vcs & ~escape_vc) != 0 ||
+            !routing_unit->escapeVCAllowed(route, outport_dirn))
+            free_vcs &= ~escape_vc;
     }
 
-    return false;
+    return free_vcs;
 }
 
 // Assign a free output VC to the winner of Switch Allocation
 int
 OutputUnit::select_free_vc(int vnet, int invc,
-         PortDirection inport_dirn, PortDirection outport_dirn, RouteInfo route)
-{
-    // ICN Lab 3:
-    // Hint: invc, route, inport_dirn, outport_dirn are provided
-    // to implement escape VC
-
-    int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, m_router->curCycle())) {
-            m_outvc_state[vc]->setState(ACTIVE_, m_router->curCycle());
-            return vc;
-        }
-    }
-
-    return -1;
+         PortDirn inport_dirn, PortDirn outport_dirn, const RouteInfo &route)
+{
+    // lowest free VC first, as the linear probe did
+    uint64_t free_vcs = allowed_vcs(vnet, outport_dirn, route);
+    if (free_vcs == 0)
+        return -1;
+
+    int vc = findLsbSet(free_vcs);
+    set_vc_state(ACTIVE_, vc, m_router->curCycle());
+    return vc;
 }
 
 /*
@@ -154,13 +193,11 @@ void
 OutputUnit::wakeup()
 {
     if (m_credit_link->isReady(m_router->curCycle())) {
-        Credit *t_credit = (Credit*) m_credit_link->consumeLink();
-        increment_credit(t_credit->get_vc());
-
-        if (t_credit->is_free_signal())
-            set_vc_state(IDLE_, t_credit->get_vc(), m_router->curCycle());
+        Credit t_credit = m_credit_link->consumeLink();
+        increment_credit(t_credit.get_vc());
 
-        delete t_credit;
+        if (t_credit.is_free_signal())
+            set_vc_state(IDLE_, t_credit.get_vc(), m_router->curCycle());
     }
 }
 
@@ -37,6 +37,7 @@
 #include <iostream>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
@@ -48,7 +49,7 @@
 class OutputUnit : public Consumer
 {
   public:
-    OutputUnit(int id, PortDirection direction, Router *router);
+    OutputUnit(int id, PortDirn direction, Router *router);
     ~OutputUnit();
     void set_out_link(NetworkLink *link);
     void set_credit_link(CreditLink *credit_link);
@@ -60,11 +61,11 @@ class OutputUnit : public Consumer
     bool has_credit(int out_vc);
     bool has_free_vc(int vnet);
     bool has_free_vc(int vnet, int invc,
-         PortDirection inport_dirn, PortDirection outport_dirn, RouteInfo route);
+         PortDirn inport_dirn, PortDirn outport_dirn, const RouteInfo &route);
     int select_free_vc(int vnet, int invc,
-         PortDirection inport_dirn, PortDirection outport_dirn, RouteInfo route);
+         PortDirn inport_dirn, PortDirn outport_dirn, const RouteInfo &route);
 
-    inline PortDirection get_direction() { return m_direction; }
+    inline PortDirn get_direction() { return m_direction; }
 
     int
     get_credit_count(int vc)
@@ -78,11 +79,7 @@ class OutputUnit : public Consumer
         return m_out_link->get_id();
     }
 
-    inline void
-    set_vc_state(VC_state_type state, int vc, Cycles curTime)
-    {
-      m_outvc_state[vc]->setState(state, curTime);
-    }
+    void set_vc_state(VC_state_type state, int vc, Cycles curTime);
 
     inline bool
     is_vc_idle(int vc, Cycles curTime)
@@ -90,6 +87,20 @@ class OutputUnit : public Consumer
         return (m_outvc_state[vc]->isInState(IDLE_, curTime));
     }
 
+    // Number of output VCs of this vnet that are idle now; a cheap
+    // measure of how congested the downstream inport is.
+    inline int
+    get_free_vc_count(int vnet)
+    {
+        return popCount(get_free_vcs(vnet));
+    }
+
+    inline uint64_t
+    get_free_vcs(int vnet)
+    {
+        return idle_vcs(m_router->curCycle()) & vnet_vcs(vnet);
+    }
+
     inline void
     insert_flit(flit *t_flit)
     {
@@ -100,21 +111,52 @@ class OutputUnit : public Consumer
     uint32_t functionalWrite(Packet *pkt);
 
     inline int get_id() { return m_id; }
+
+    // Router and inport at the far end of the out link; -1 for links
+    // to a network interface
+    void
+    set_downstream(int router, int inport)
+    {
+        m_downstream_router = router;
+        m_downstream_inport = inport;
+    }
+    inline int get_downstream_router() { return m_downstream_router; }
+    inline int get_downstream_inport() { return m_downstream_inport; }
+
     NetworkLink *m_out_link;
     std::vector<OutVcState *> m_outvc_state; // vc state of downstream router
 
   private:
     int m_id;
-    PortDirection m_direction;
+    PortDirn m_direction;
     int m_num_vcs;
     int m_vc_per_vnet;
     Router *m_router;
     //NetworkLink *m_out_link;
     CreditLink *m_credit_link;
 
+    int m_downstream_router;
+    int m_downstream_inport;
+
     flitBuffer *m_out_buffer; // This is for the network link to consume
     //std::vector<OutVcState *> m_outvc_state; // vc state of downstream router
 
+    // Bit vc is set while m_outvc_state[vc] is IDLE_. VCs that were
+    // made IDLE_ at a future cycle are also in m_deferred_idle_vcs
+    // until that cycle is reached.
+    uint64_t m_idle_vcs;
+    uint64_t m_deferred_idle_vcs;
+
+    uint64_t idle_vcs(Cycles curTime);
+    uint64_t allowed_vcs(int vnet, PortDirn outport_dirn,
+                         const RouteInfo &route);
+
+    inline uint64_t
+    vnet_vcs(int vnet)
+    {
+        return mask(m_vc_per_vnet) << (vnet * m_vc_per_vnet);
+    }
+
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_OUTPUTUNIT_HH__
@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/Router.hh"
 
+#include "base/bitfield.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
@@ -42,6 +43,7 @@
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
+#include "mem/ruby/network/garnet2.0/SwapTurn.hh"
 #include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
 
 using namespace std;
@@ -54,10 +56,15 @@ Router::Router(const Params *p)
     m_virtual_networks = p->virt_nets;
     m_vc_per_vnet = p->vcs_per_vnet;
     m_num_vcs = m_virtual_networks * m_vc_per_vnet;
+    assert(m_num_vcs <= 64);
+    m_vnet_base_vcs = 0;
+    for (int vnet = 0; vnet < m_virtual_networks; vnet++)
+        m_vnet_base_vcs |= (1ULL << (vnet * m_vc_per_vnet));
 
     m_routing_unit = new RoutingUnit(this);
     m_sw_alloc = new SwitchAllocator(this);
     m_switch = new CrossbarSwitch(this);
+    m_swap_turn = NULL;
 
     m_input_unit.clear();
     m_output_unit.clear();
@@ -69,7 +76,7 @@ Router::Router(const Params *p)
     swap_ptr.inport = -1;
     swap_ptr.vcid = -1;
     swap_ptr.vnet_id = -1;
-    swap_ptr.inport_dirn = "Unknown";
+    swap_ptr.inport_dirn = UNKNOWN_DIRN_;
     send_routedSwap = false;
     // print_trigger = Cycles(100);
 }
@@ -81,6 +88,7 @@ Router::~Router()
     delete m_routing_unit;
     delete m_sw_alloc;
     delete m_switch;
+    delete m_swap_turn;
 }
 
 void
@@ -90,12 +98,27 @@ Router::init()
 
     m_sw_alloc->init();
     m_switch->init();
+    m_routing_unit->init();
+
+    if (get_net_ptr()->isEnableInterswap()) {
+        Cycles period(get_net_ptr()->get_whenToSwap() *
+                      get_net_ptr()->getNumRouters());
+        m_swap_turn = new SwapTurn(this, period);
+    }
+}
+
+// A flit that may be swapped came in: wake up at the next turn
+void
+Router::arm_swap_turn()
+{
+    if (m_swap_turn != NULL)
+        m_swap_turn->arm();
 }
 
 int
-Router::get_numFreeVC(PortDirection dirn_) {
-    assert(dirn_ != "Local");
-    int inport_id = m_routing_unit->m_inports_dirn2idx[dirn_];
+Router::get_numFreeVC(PortDirn dirn_) {
+    assert(dirn_ != LOCAL_DIRN_);
+    int inport_id = m_routing_unit->inportIdx(dirn_);
 
     return (m_input_unit[inport_id]->get_numFreeVC(dirn_));
 }
@@ -106,7 +129,7 @@ Router::vcStateDump()
 {
     for (int inport=0; inport < m_input_unit.size(); ++inport) {
         cout << "inport: " << inport << "; direction: " <<
-            m_routing_unit->m_inports_idx2dirn[inport] << endl;
+            m_routing_unit->inportDirn(inport) << endl;
         for (int vc_ = 0; vc_ < m_vc_per_vnet; ++vc_) {
             cout << "vcid: " << vc_ << "state: " <<
                 m_input_unit[inport]->m_vcs[vc_]->get_state() << endl;
@@ -140,205 +163,9 @@ Router::wakeup()
         }
     #endif
 
-    if (get_net_ptr()->isEnableInterswap()) {
-
-        #if (MY_PRINT)
-        cout << "this->is_myTurn(): " << this->is_myTurn() << endl;
-        cout << "swap_ptr.valid: " << swap_ptr.valid << "; swap_ptr.inport: " <<
-            swap_ptr.inport << "; swap_ptr.vcid: "  << swap_ptr.vcid << endl;
-        cout << "-----------------------------------------------" << endl;
-        #endif
-
-        // Make swap_ptr valid here if possible...
-        if ((swap_ptr.valid == false)) {
-             int inport_itr;
-             int invc = 0;
-             bool swap_ptr_valid = false;
-             for(inport_itr=0; inport_itr< m_input_unit.size(); ++inport_itr) {
-                // Just check the VC-base of each VNet in that input unit
-                // if there is a flit presrnt then make the swap_ptr valid.
-                if(m_input_unit[inport_itr]->get_direction() == "Local") {
-                    // if(get_net_ptr()->m_whichToSwap == DISABLE_LOCAL_SWAP_) {
-                         continue;
-                    // }
-                }
-                else {
-                    for(int vnet=0; vnet < m_virtual_networks; ++vnet) {
-                        invc = vnet*m_vc_per_vnet;
-                        if ( m_input_unit[inport_itr]->vc_isEmpty(invc) == false ) {
-                            flit* t_flit = m_input_unit[inport_itr]->peekTopFlit(invc);
-                            m_input_unit[inport_itr]->makeSwapPtrValid(t_flit);
-                            swap_ptr_valid = true;
-                            break;
-                        }
-                        else {
-                            continue;
-                        }
-                    }
-                }
-                if(swap_ptr_valid)
-                    break;
-             }
-        }
-
-        #if (MY_PRINT)
-        cout << "-----------------------------------------------" << endl;
-        cout << "this->is_myTurn(): " << this->is_myTurn() << endl;
-        cout << "swap_ptr.valid: " << swap_ptr.valid << "; swap_ptr.inport: " <<
-            swap_ptr.inport << "; swap_ptr.vcid: "  << swap_ptr.vcid << endl;
-        #endif
-
-
-        if ((this->is_myTurn()) && (swap_ptr.valid)) {
-            #if (MY_PRINT)
-                cout << "Router id: " << m_id <<" swap_ptr.valid: "\
-                << swap_ptr.valid <<" swap_ptr.inport: " << swap_ptr.inport <<
-                " swap_ptr.vcid: " << swap_ptr.vcid <<
-                " swap_ptr.inport_dirn: " << swap_ptr.inport_dirn << endl;
-            #endif
-            assert(swap_ptr.inport_dirn ==
-                    m_input_unit[swap_ptr.inport]->get_direction());
-
-            assert((swap_ptr.inport != -1) && (swap_ptr.vcid != -1));
-            // if either
-            // the outport in the flit is "Local"
-            // OR,
-            // when there is no flit in the input queue
-            // then do not do the swap; just change
-            // the direction of swap_ptr of router.
-            // and 'return'
-            if (outportNotLocal()) {
-                #if (MY_PRINT)
-                    cout << "initiating the swap" << endl;
-                #endif
-
-                // Swap is initiated: (update the stats)
-                get_net_ptr()->m_total_initiated_swaps++;
-
-                // Do all of it when 'is_swap' bit is enabled
-                if (get_net_ptr()->m_no_is_swap == 0) {
-                    /*Check for deadlck_symtm first.*/
-                    bool deadlck_symtm = false;
-                    // do this on per vnet basis
-
-                    deadlck_symtm = get_net_ptr()->chk_deadlck_symptm(m_id, 0);
-
-                    if (deadlck_symtm) {
-                        /*initiate bailout sequence and then proceed normally*/
-                        #if (MY_PRINT)
-                        cout << "----initiating bail_out sequence----" << endl;
-                        #endif
-                        get_net_ptr()->bail_out(m_id);
-                        get_net_ptr()->m_total_bailout++;
-                    } else {
-                        // proceed normally via doSwap()
-                    }
-                } else {
-                    // this condition is also true when
-                    // 'm_inj_single_vnet == 0'
-                    assert(get_net_ptr()->m_no_is_swap == 1);
-                }
-                // If the result of GarnetNetwork::doSwap()
-                // is not NULL then remove the flit from inport by doing
-                // getTopFlit
-                #if (MY_PRINT)
-                    cout << "Upstream Router-id: " << m_id <<" swap_ptr.inport: "\
-                         << swap_ptr.inport << endl;
-                    cout << "swap_ptr.vcid: " << swap_ptr.vcid <<" swap_ptr.inport_dirn: "\
-                         << swap_ptr.inport_dirn << endl;
-                    cout << "Candidate flit of upstream router: " << endl;
-                    cout << *m_input_unit[swap_ptr.inport]->peekTopFlit(swap_ptr.vcid)
-                         << endl;
-                #endif
-                // taking care of the case when the flit itself is RoutedSwap
-                // and is pointed by the swap_ptr.
-                if (m_input_unit[swap_ptr.inport]->peekTopFlit(swap_ptr.vcid)\
-                    ->get_RoutedSwap()) {
-                    // here the swapped flit is trying to make forward progress
-                    // via swaps. set the flag, which will be used later to
-                    // clear 'is_swap' bit of this router and
-                    // keep 'routedSwap' bit in the flit high.
-                    #if (MY_PRINT)
-                        cout << "'routedSwap' flit is trying to make forward"\
-                                 "progress via Swap!" << endl;
-                    #endif
-                    if (get_net_ptr()->m_no_is_swap == 0) {
-                        assert(this->is_swap);
-                    }
-                    this->send_routedSwap = true; // setting the flag
-
-                }
-                // because we have made sure swap_ptr always points to non-empty
-                // vcid
-                flit* flit_t = get_net_ptr()->doSwap(
-                                            m_input_unit[swap_ptr.inport]->\
-                                            peekTopFlit(swap_ptr.vcid), m_id);
-
-                // by upstream router:
-                // 1. Recompute the route (happens in doSwap_enqueue())
-                // 2. insert this flit in the router
-                if (flit_t != NULL) {
-                    // remove the flit from the input port of that input unit...
-                    m_input_unit[swap_ptr.inport]->getTopFlit(swap_ptr.vcid);
-                    #if (MY_PRINT)
-                        cout << "Mis-routed flit we got from downstream"\
-                             << "router: " << endl;
-                        cout << *flit_t << endl;
-                        cout <<"Router-id: " << m_id <<
-                            " swap_ptr.inport_dirn: " <<
-                            swap_ptr.inport_dirn <<
-                            " swap_ptr.vcid: " << swap_ptr.vcid <<
-                            endl;
-                    #endif
-                    doSwap_enqueue(flit_t, m_input_unit[swap_ptr.inport]->\
-                                    get_direction(), swap_ptr.inport, swap_ptr.vcid);
-                    #if (MY_PRINT)
-                        cout << "<<<<<<Completed the swap successfully>>>>>"\
-                            << endl;
-                    #endif
-                    // update the stats
-                    get_net_ptr()->increment_total_swaps();
-
-                    if (this->send_routedSwap) {
-                        if (get_net_ptr()->m_no_is_swap == 0) {
-                            assert(this->is_swap);
-                        }
-                        this->send_routedSwap = false;
-                        this->is_swap = false;
-                        // the flit has made forward progress using swaps from
-                        // downstream router
-                        get_net_ptr()->m_total_routedSwaps++;
-                    }
-
-                }
-                else {
-                    // Swap is not possible because either:
-                    // 1. swap_ptr is sending it flit for Local outport out
-                    // 2. Downstream router's inport is empty.. the flit will
-                    // then go by usual SwitchArbiteration mechanism.
-                    // 3. Downstream Router's 'is_swap' bit is high
-                    // 4. Downstream Router's mis-route flit has Local outport
-
-                    //Therfore if 'send_routedSwap' is set before clear it here.
-                    if (this->send_routedSwap) {
-                        if (get_net_ptr()->m_no_is_swap == 0) {
-                            assert(this->is_swap);
-                        }
-                        this->send_routedSwap = false;
-                    }
-                    get_net_ptr()->m_total_failed_swaps++;
-                }
-            }
-            else {
-                // swap is not possible because there is no flit in the
-                // input port's vc-0 in the upstream router to swap with
-            }
-
-            // THis is the upstream router irrespective of completing/not-complting
-            // the swap---update the direction of swap_ptr.
-            movSwapPtr(); // only move swap_ptr when it's valid
-        }
-    }
+    // iSWAP turn, if this cycle is it, before anything else moves
+    if (m_swap_turn != NULL)
+        m_swap_turn->take();
 
     // check for incoming flits
     for (int inport = 0; inport < m_input_unit.size(); inport++) {
@@ -367,6 +194,216 @@ Router::wakeup()
     #endif
 }
 
+// Point swap_ptr at the head flit of the lowest vnet of a non-Local
+// inport, unless it is valid already; returns whether it is valid.
+bool
+Router::find_swap_candidate()
+{
+    if (swap_ptr.valid)
+        return true;
+
+    for (int inport = 0; inport < m_input_unit.size(); ++inport) {
+        if (m_input_unit[inport]->get_direction() == LOCAL_DIRN_)
+            continue;
+        // Just check the VC-base of each VNet in that input unit
+        uint64_t vnet_heads =
+            m_input_unit[inport]->get_occupied_vcs() & m_vnet_base_vcs;
+        if (vnet_heads) {
+            // lowest occupied VC-base is the lowest vnet
+            int invc = findLsbSet(vnet_heads);
+            flit* t_flit = m_input_unit[inport]->peekTopFlit(invc);
+            m_input_unit[inport]->makeSwapPtrValid(t_flit);
+            break;
+        }
+    }
+
+    return swap_ptr.valid;
+}
+
+int
+Router::swap_candidate_blocked_cycles()
+{
+    assert(swap_ptr.valid);
+    if (!m_sw_alloc->is_blocked(swap_ptr.inport, swap_ptr.vcid))
+        return -1;
+    return m_sw_alloc->get_blocked_cycles(swap_ptr.inport, swap_ptr.vcid);
+}
+
+// One iSWAP turn of this router, run by m_swap_turn at its TDM slot,
+// at the start of wakeup().
+// Returns true if the router still holds a flit it could swap.
+bool
+Router::swap_turn()
+{
+    assert(get_net_ptr()->isEnableInterswap());
+
+    if (!find_swap_candidate())
+        return false;
+
+    #if (MY_PRINT)
+        cout << "Router id: " << m_id <<" swap_ptr.valid: "\
+        << swap_ptr.valid <<" swap_ptr.inport: " << swap_ptr.inport <<
+        " swap_ptr.vcid: " << swap_ptr.vcid <<
+        " swap_ptr.inport_dirn: " << swap_ptr.inport_dirn << endl;
+    #endif
+    assert(swap_ptr.inport_dirn ==
+            m_input_unit[swap_ptr.inport]->get_direction());
+
+    assert((swap_ptr.inport != -1) && (swap_ptr.vcid != -1));
+    // if either
+    // the outport in the flit is "Local"
+    // OR,
+    // when there is no flit in the input queue
+    // then do not do the swap; just change
+    // the direction of swap_ptr of router.
+    // and 'return'
+    // with a threshold, only a candidate blocked for that long is
+    // swapped; others are left to SA
+    bool swap_candidate = outportNotLocal();
+    int blocked_cycles = swap_candidate ? swap_candidate_blocked_cycles()
+                                        : -1;
+    uint32_t threshold = get_net_ptr()->getSwapBlockedThreshold();
+    if (swap_candidate && threshold > 0 && blocked_cycles < (int) threshold) {
+        get_net_ptr()->m_total_skipped_swaps++;
+        swap_candidate = false;
+    }
+
+    if (swap_candidate) {
+        #if (MY_PRINT)
+            cout << "initiating the swap" << endl;
+        #endif
+
+        // Swap is initiated: (update the stats)
+        get_net_ptr()->m_total_initiated_swaps++;
+        if (blocked_cycles >= 0)
+            get_net_ptr()->m_total_blocked_swaps++;
+
+        // Do all of it when 'is_swap' bit is enabled
+        if (get_net_ptr()->m_no_is_swap == 0) {
+            /*Check for deadlck_symtm first.*/
+            bool deadlck_symtm = false;
+            // do this on per vnet basis
+
+            int vnet = swap_ptr.vcid / m_vc_per_vnet;
+            deadlck_symtm = get_net_ptr()->chk_deadlck_symptm(m_id, vnet);
+
+            if (deadlck_symtm) {
+                /*initiate bailout sequence and then proceed normally*/
+                #if (MY_PRINT)
+                cout << "----initiating bail_out sequence----" << endl;
+                #endif
+                get_net_ptr()->bail_out(m_id, vnet);
+                get_net_ptr()->m_total_bailout++;
+            } else {
+                // proceed normally via doSwap()
+            }
+        } else {
+            // this condition is also true when
+            // 'm_inj_single_vnet == 0'
+            assert(get_net_ptr()->m_no_is_swap == 1);
+        }
+        // If the result of GarnetNetwork::doSwap()
+        // is not NULL then remove the flit from inport by doing
+        // getTopFlit
+        #if (MY_PRINT)
+            cout << "Upstream Router-id: " << m_id <<" swap_ptr.inport: "\
+                 << swap_ptr.inport << endl;
+            cout << "swap_ptr.vcid: " << swap_ptr.vcid <<" swap_ptr.inport_dirn: "\
+                 << swap_ptr.inport_dirn << endl;
+            cout << "Candidate flit of upstream router: " << endl;
+            cout << *m_input_unit[swap_ptr.inport]->peekTopFlit(swap_ptr.vcid)
+                 << endl;
+        #endif
+        // taking care of the case when the flit itself is RoutedSwap
+        // and is pointed by the swap_ptr.
+        if (m_input_unit[swap_ptr.inport]->peekTopFlit(swap_ptr.vcid)\
+            ->get_RoutedSwap()) {
+            // here the swapped flit is trying to make forward progress
+            // via swaps. set the flag, which will be used later to
+            // clear 'is_swap' bit of this router and
+            // keep 'routedSwap' bit in the flit high.
+            #if (MY_PRINT)
+                cout << "'routedSwap' flit is trying to make forward"\
+                         "progress via Swap!" << endl;
+            #endif
+            if (get_net_ptr()->m_no_is_swap == 0) {
+                assert(this->is_swap);
+            }
+            this->send_routedSwap = true; // setting the flag
+
+        }
+        // because we have made sure swap_ptr always points to non-empty
+        // vcid
+        flit* flit_t = get_net_ptr()->doSwap(
+                                    m_input_unit[swap_ptr.inport]->\
+                                    peekTopFlit(swap_ptr.vcid), m_id);
+
+        // by upstream router:
+        // 1. Recompute the route (happens in doSwap_enqueue())
+        // 2. insert this flit in the router
+        if (flit_t != NULL) {
+            // remove the flit from the input port of that input unit...
+            m_input_unit[swap_ptr.inport]->getTopFlit(swap_ptr.vcid);
+            #if (MY_PRINT)
+                cout << "Mis-routed flit we got from downstream"\
+                     << "router: " << endl;
+                cout << *flit_t << endl;
+                cout <<"Router-id: " << m_id <<
+                    " swap_ptr.inport_dirn: " <<
+                    swap_ptr.inport_dirn <<
+                    " swap_ptr.vcid: " << swap_ptr.vcid <<
+                    endl;
+            #endif
+            doSwap_enqueue(flit_t, swap_ptr.inport, swap_ptr.vcid, false);
+            #if (MY_PRINT)
+                cout << "<<<<<<Completed the swap successfully>>>>>"\
+                    << endl;
+            #endif
+            // update the stats
+            get_net_ptr()->increment_total_swaps();
+
+            if (this->send_routedSwap) {
+                if (get_net_ptr()->m_no_is_swap == 0) {
+                    assert(this->is_swap);
+                }
+                this->send_routedSwap = false;
+                this->is_swap = false;
+                // the flit has made forward progress using swaps from
+                // downstream router
+                get_net_ptr()->m_total_routedSwaps++;
+            }
+
+        }
+        else {
+            // Swap is not possible because either:
+            // 1. swap_ptr is sending it flit for Local outport out
+            // 2. Downstream router's inport is empty.. the flit will
+            // then go by usual SwitchArbiteration mechanism.
+            // 3. Downstream Router's 'is_swap' bit is high
+            // 4. Downstream Router's mis-route flit has Local outport
+
+            //Therfore if 'send_routedSwap' is set before clear it here.
+            if (this->send_routedSwap) {
+                if (get_net_ptr()->m_no_is_swap == 0) {
+                    assert(this->is_swap);
+                }
+                this->send_routedSwap = false;
+            }
+            get_net_ptr()->m_total_failed_swaps++;
+        }
+    }
+    else {
+        // swap is not possible because there is no flit in the
+        // input port's vc-0 in the upstream router to swap with
+    }
+
+    // THis is the upstream router irrespective of completing/not-complting
+    // the swap---update the direction of swap_ptr.
+    movSwapPtr(); // only move swap_ptr when it's valid
+
+    return find_swap_candidate();
+}
+
 void
 Router::movSwapPtr() {
     // THis is the upstream router irrespective of completing/not-complting
@@ -381,8 +418,9 @@ Router::movSwapPtr() {
     // int num_vnet = m_virtual_networks;
 
     // int num_vcs = get_num_vcs();
-    int itr;
+    int start_vc = swap_ptr.vcid;
     int invc = -1;
+    assert(start_vc >= 0);
 
     for (int inport = 0; inport < get_num_inports(); inport++) {
         // simpler swap_ptr movement logic
@@ -390,26 +428,27 @@ Router::movSwapPtr() {
         if (swap_ptr.inport == get_num_inports())
           swap_ptr.inport = 0; // looping over
         if (get_net_ptr()->get_whichToSwap() == DISABLE_LOCAL_SWAP_) {
-            if (m_input_unit[swap_ptr.inport]->get_direction() == "Local")
+            if (m_input_unit[swap_ptr.inport]->get_direction() == LOCAL_DIRN_)
                 continue;
         }
 
-        for (itr= 0; itr < get_num_vcs(); itr++) {
-            invc = swap_ptr.vcid++;
-            if (invc >= m_num_vcs) {
-                invc = 0;
-            }
-            if((m_input_unit[swap_ptr.inport]->vc_isEmpty(invc) == false)) {
-                goto jmp;
-            }
-            else {
-                continue;
-            }
+        // The first inport visited resumes at the old vcid and then
+        // falls back to VC 0; every later inport only looks at VC 0.
+        uint64_t occupied = m_input_unit[swap_ptr.inport]->get_occupied_vcs();
+        uint64_t upper = (start_vc < m_num_vcs) ?
+                         (occupied & (~0ULL << start_vc)) : 0;
+        start_vc = m_num_vcs;
+        if (upper) {
+            invc = findLsbSet(upper);
+            break;
+        }
+        if (occupied & 1ULL) {
+            invc = 0;
+            break;
         }
     }
 
-   jmp:
-    if ( m_input_unit[swap_ptr.inport]->vc_isEmpty(invc) == false ) {
+    if (invc != -1) {
         swap_ptr.inport_dirn = m_input_unit[swap_ptr.inport]->get_direction();
         swap_ptr.vcid = invc;
         swap_ptr.valid = true;
@@ -428,11 +467,11 @@ Router::movSwapPtr() {
         // update the dirn of swap_ptr here.
         // At this point swap_ptr.inport should be pointing to the next input-unit
         // of upstream router. Therefore, set that direction in the swap_ptr.
-        swap_ptr.inport_dirn = m_routing_unit->m_inports_idx2dirn[swap_ptr.inport];
-        assert(swap_ptr.inport_dirn.length() != 0); // shouldn't be an empty string
+        swap_ptr.inport_dirn = m_routing_unit->inportDirn(swap_ptr.inport);
+        assert(swap_ptr.inport_dirn != UNKNOWN_DIRN_); // shouldn't be unknown
 
         if (get_net_ptr()->get_whichToSwap() == DISABLE_LOCAL_SWAP_)
-            assert(swap_ptr.inport_dirn != "Local"); // should not point to a local inport
+            assert(swap_ptr.inport_dirn != LOCAL_DIRN_); // should not point to a local inport
 
         #if (MY_PRINT)
             cout << "After movSwapPtr(): swap_ptr.inport: " << swap_ptr.inport << \
@@ -496,7 +535,7 @@ Router::outportNotLocal() {
         // pointed by this swap_pointer; if it is
         // greater then let the code fall through
         // otherwise return 'false'
-        PortDirection dirn_ =
+        PortDirn dirn_ =
                     m_input_unit[swap_ptr.inport]->get_direction();
         int free_vc =
                 m_input_unit[swap_ptr.inport]->get_numFreeVC(dirn_);
@@ -514,13 +553,13 @@ Router::outportNotLocal() {
         return false;
     }
     int outport = m_input_unit[inport]->peekTopFlit(vcid)->get_outport();
-    PortDirection outport_dir = m_input_unit[inport]->\
+    PortDirn outport_dir = m_input_unit[inport]->\
                                 peekTopFlit(vcid)->get_outport_dir();
     // sanity check:
-    assert(outport_dir.length() != 0);
+    assert(outport_dir != UNKNOWN_DIRN_);
     assert(m_output_unit[outport]->get_direction() == outport_dir);
 
-    if (outport_dir == "Local") {
+    if (outport_dir == LOCAL_DIRN_) {
         #if (MY_PRINT)
             cout << "Cannot swap because outport of the flit is pointing to"\
                     " local port of this router" << endl;
@@ -533,14 +572,12 @@ Router::outportNotLocal() {
 }
 
 flit*
-Router::doSwap(PortDirection inport_dirn, int vcid)
+Router::doSwap(int inport, int vcid)
 {
     // this should have been taken care of by caller.
-    assert(inport_dirn != "Local");
+    assert(m_input_unit[inport]->get_direction() != LOCAL_DIRN_);
     // additional check.. only swap when all the
     // vcs for the given inport are NOT empty..
-    int inport;
-    inport = m_routing_unit->m_inports_dirn2idx[inport_dirn];
 
     if (get_net_ptr()->m_no_is_swap == 0) {
         if (is_swap == false) {
@@ -551,7 +588,7 @@ Router::doSwap(PortDirection inport_dirn, int vcid)
              } else {
                 flit* flit_t = m_input_unit[inport]->peekTopFlit(vcid);
                 // do not return the flit whoes outport is "Local"
-                if (flit_t->get_outport_dir() == "Local") {
+                if (flit_t->get_outport_dir() == LOCAL_DIRN_) {
                     get_net_ptr()->m_total_failed_downstream_localOutport;
                     return NULL;
                 } else {
@@ -575,7 +612,7 @@ Router::doSwap(PortDirection inport_dirn, int vcid)
          } else {
             flit* flit_t = m_input_unit[inport]->peekTopFlit(vcid);
             // do not return the flit whoes outport is "Local"
-            if (flit_t->get_outport_dir() == "Local") {
+            if (flit_t->get_outport_dir() == LOCAL_DIRN_) {
                 get_net_ptr()->m_total_failed_downstream_localOutport;
                 #if (MY_PRINT)
                     cout << "Declining SWAP because the flit is at its destination" << endl;
@@ -595,43 +632,46 @@ Router::doSwap(PortDirection inport_dirn, int vcid)
 }
 
 void
-Router::doSwap_enqueue(flit * flit_t, PortDirection inport_dirn,
-int inport_id, int vcid)
+Router::doSwap_enqueue(flit * flit_t, int inport, int vcid, bool routed)
 {
+    PortDirn inport_dirn = m_input_unit[inport]->get_direction();
     if (get_net_ptr()->get_whichToSwap() == ENABLE_LOCAL_SWAP_) {
-        if (inport_id == -1) // called by upstream router
-            assert(inport_dirn != "Local");
+        if (routed) // called by upstream router
+            assert(inport_dirn != LOCAL_DIRN_);
     } else
-        assert(inport_dirn != "Local");
+        assert(inport_dirn != LOCAL_DIRN_);
 
     // set this new vc in the flit (which is same as vcid of the upstream router)
     flit_t->set_vc(vcid);
+
+    // a routed flit moves one router along its path, a mis-routed one
+    // goes back to the router it came from
+    if (routed)
+        flit_t->advance_path();
+    else
+        flit_t->retreat_path();
+    flit_t->reach_router(m_id);
+
     int vc = flit_t->get_vc();
 
     int outport =
-        route_compute(flit_t->get_route(),
-                      m_routing_unit->\
-                      m_inports_dirn2idx[inport_dirn],
-                      inport_dirn, vc);
+        route_compute(flit_t->get_route(), inport, inport_dirn, vc);
     flit_t->set_outport(outport);
     flit_t->set_outport_dir(m_routing_unit->\
-                            m_outports_idx2dirn[outport]);
+                            outportDirn(outport));
     
     assert(vc != -1);
-    if (inport_id == -1) {
-        // This means we are enqueuing a "Routed" flit
-        // in downstream router.
-        inport_id = m_routing_unit->m_inports_dirn2idx[inport_dirn];
-        assert(inport_id != -1);
-    } else {
-
+    if (!routed) {
+        // a mis-routed flit back in the upstream router
         if (get_net_ptr()->m_no_is_swap == 0) {
             assert(flit_t->get_RoutedSwap() == false);
         }
-        assert(m_routing_unit->m_inports_idx2dirn[inport_id] ==
-            inport_dirn);
     }
-    m_input_unit[inport_id]->enqueue_flit(vc, flit_t);
+    m_input_unit[inport]->enqueue_flit(vc, flit_t);
+    // the other router of a swap runs it from its own wakeup(): let
+    // SA see the new flit
+    schedule_wakeup(Cycles(1));
+    arm_swap_turn();
     return;
 
 }
@@ -647,7 +687,8 @@ Router::checkSwapPtrValid() {
 }
 
 void
-Router::makeSwapPtrValid(PortDirection dirn, int vc) {
+Router::makeSwapPtrValid(int inport, int vc) {
+    PortDirn dirn = m_input_unit[inport]->get_direction();
     #if (MY_PRINT)
         cout << "Router::makeSwapPtrValid(); Direction: " << dirn << endl;
     #endif
@@ -656,13 +697,13 @@ Router::makeSwapPtrValid(PortDirection dirn, int vc) {
     swap_ptr.valid = true;
     swap_ptr.inport_dirn = dirn;
     swap_ptr.vcid = vc;
-    assert(dirn != "Local");
-    swap_ptr.inport = m_routing_unit->m_inports_dirn2idx[dirn];
+    assert(dirn != LOCAL_DIRN_);
+    swap_ptr.inport = inport;
     return;
 }
 
 void
-Router::addInPort(PortDirection inport_dirn,
+Router::addInPort(PortDirn inport_dirn,
                   NetworkLink *in_link, CreditLink *credit_link)
 {
     int port_num = m_input_unit.size();
@@ -679,7 +720,7 @@ Router::addInPort(PortDirection inport_dirn,
 }
 
 void
-Router::addOutPort(PortDirection outport_dirn,
+Router::addOutPort(PortDirn outport_dirn,
                    NetworkLink *out_link,
                    const NetDest& routing_table_entry, int link_weight,
                    CreditLink *credit_link)
@@ -699,13 +740,13 @@ Router::addOutPort(PortDirection outport_dirn,
     m_routing_unit->addOutDirection(outport_dirn, port_num);
 }
 
-PortDirection
+PortDirn
 Router::getOutportDirection(int outport)
 {
     return m_output_unit[outport]->get_direction();
 }
 
-PortDirection
+PortDirn
 Router::getInportDirection(int inport)
 {
     return m_input_unit[inport]->get_direction();
@@ -713,9 +754,16 @@ Router::getInportDirection(int inport)
 
 
 int
-Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn,
+Router::route_compute(const RouteInfo &route, int inport, PortDirn inport_dirn,
                      int vc)
 {
+    // source routed flits carry their outport for this router
+    if (route.path_id != -1) {
+        const SourceRoute &path = get_net_ptr()->getSourceRoute(route.path_id);
+        assert(route.path_hop >= 0 && route.path_hop < path.len);
+        return path.port[route.path_hop];
+    }
+
     return m_routing_unit->outportCompute(route, inport, inport_dirn, vc);
 }
 
@@ -731,6 +779,12 @@ Router::has_free_vc(int outport, int vnet)
     return m_output_unit[outport]->has_free_vc(vnet);
 }
 
+int
+Router::get_free_vc_count(int outport, int vnet)
+{
+    return m_output_unit[outport]->get_free_vc_count(vnet);
+}
+
 void
 Router::schedule_wakeup(Cycles time)
 {
@@ -739,13 +793,10 @@ Router::schedule_wakeup(Cycles time)
 }
 
 std::string
-Router::getPortDirectionName(PortDirection direction)
+Router::getPortDirectionName(PortDirn direction)
 {
-    // PortDirection is actually a string
-    // If not, then this function should add a switch
-    // statement to convert direction to a string
-    // that can be printed out
-    return direction;
+    // PortDirn is an interned id; look up the topology name
+    return port_dirn_name(direction);
 }
 
 void
@@ -52,6 +52,7 @@ class OutputUnit;
 class RoutingUnit;
 class SwitchAllocator;
 class CrossbarSwitch;
+class SwapTurn;
 class FaultModel;
 
 class Router : public BasicRouter, public Consumer
@@ -66,9 +67,9 @@ class Router : public BasicRouter, public Consumer
     void print(std::ostream& out) const {};
 
     void init();
-    void addInPort(PortDirection inport_dirn, NetworkLink *link,
+    void addInPort(PortDirn inport_dirn, NetworkLink *link,
                    CreditLink *credit_link);
-    void addOutPort(PortDirection outport_dirn, NetworkLink *link,
+    void addOutPort(PortDirn outport_dirn, NetworkLink *link,
                     const NetDest& routing_table_entry,
                     int link_weight, CreditLink *credit_link);
 
@@ -80,7 +81,8 @@ class Router : public BasicRouter, public Consumer
     int get_num_outports()  { return m_output_unit.size(); }
     int get_id()            { return m_id; }
     bool has_free_vc(int outport, int vnet);
-    int get_numFreeVC(PortDirection dirn_);
+    int get_free_vc_count(int outport, int vnet);
+    int get_numFreeVC(PortDirn dirn_);
 
     void vcStateDump(void);
 
@@ -93,16 +95,17 @@ class Router : public BasicRouter, public Consumer
     std::vector<InputUnit *>& get_inputUnit_ref()   { return m_input_unit; }
     std::vector<OutputUnit *>& get_outputUnit_ref() { return m_output_unit; }
     RoutingUnit* get_routingUnit_ref() {     return  m_routing_unit; }
-    PortDirection getOutportDirection(int outport);
-    PortDirection getInportDirection(int inport);
+    SwitchAllocator* get_switchAllocator_ref() { return m_sw_alloc; }
+    PortDirn getOutportDirection(int outport);
+    PortDirn getInportDirection(int inport);
 
-    int route_compute(RouteInfo route, int inport, PortDirection direction,
+    int route_compute(const RouteInfo &route, int inport, PortDirn direction,
                       int vc);
-    //int route_compute(RouteInfo route, int inport, PortDirection direction);
+    //int route_compute(const RouteInfo &route, int inport, PortDirection direction);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
-    std::string getPortDirectionName(PortDirection direction);
+    std::string getPortDirectionName(PortDirn direction);
     void printFaultVector(std::ostream& out);
     void printAggregateFaultProbability(std::ostream& out);
 
@@ -128,7 +131,7 @@ class Router : public BasicRouter, public Consumer
     uint32_t functionalWrite(Packet *);
 
     bool checkSwapPtrValid();
-    void makeSwapPtrValid(PortDirection dirn, int vcid);
+    void makeSwapPtrValid(int inport, int vcid);
     // InterSwap
     // 'is_swap' to avoid downstram router taking part in
     // swap on the request of upstream router
@@ -143,18 +146,26 @@ class Router : public BasicRouter, public Consumer
 		// direction of the inport to which its
 		// pointing
 		int vnet_id;
-		PortDirection inport_dirn;
+		PortDirn inport_dirn;
 	} swap_ptr;
 
     void movSwapPtr();
     bool outportNotLocal();
+    bool find_swap_candidate();
+    // cycles the swap candidate has waited for a VC, -1 if it is not
+    // blocked (see SwitchAllocator::is_blocked)
+    int swap_candidate_blocked_cycles();
+    // iSWAP turns, see SwapTurn
+    bool swap_turn();
+    void arm_swap_turn();
 	// Router's doSwap function: it will check if the queue
 	// is empty or not; of empty then return NULL otherwise
 	// return the head-flit from that input-queue
-	flit* doSwap(PortDirection inport_dirn, int vcid);
+	flit* doSwap(int inport, int vcid);
 
-    // this will enqueue the flit into the input queue
-    void doSwap_enqueue(flit* flit_t, PortDirection inport_dirn, int inport_id, int vcid);
+    // this will enqueue the flit into the input queue; 'routed' if it
+    // comes from the upstream router, else it was mis-routed back
+    void doSwap_enqueue(flit* flit_t, int inport, int vcid, bool routed);
 
     void scanRouter( void );
 
@@ -171,98 +182,6 @@ class Router : public BasicRouter, public Consumer
       send_routedSwap = val;
     }
 
-    inline bool
-    is_myTurn() {
-
-        assert(get_net_ptr()->isEnableInterswap() == true);
-
-        int tdm_ = get_net_ptr()->get_whenToSwap();
-
-        if (curCycle()%(tdm_*(get_net_ptr()->getNumRouters())) == m_id) {
-            return true;
-        } else {
-            return false;
-        }
-
-        if (get_net_ptr()->get_whenToSwap() == TDM_) {
-            if (curCycle()%(get_net_ptr()->getNumRouters()) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        } else if (get_net_ptr()->get_whenToSwap() == _2_TDM_) {
-            if (curCycle()%(2*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        } else if (get_net_ptr()->get_whenToSwap() == _4_TDM_) {
-            if (curCycle()%(4*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        } else if (get_net_ptr()->get_whenToSwap() == _8_TDM_) {
-            if (curCycle()%(8*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        } else if (get_net_ptr()->get_whenToSwap() == _16_TDM_) {
-            if ((curCycle())%(16*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        } else if (get_net_ptr()->get_whenToSwap() == _32_TDM_) {
-            if ((curCycle())%(32*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        }  else if (get_net_ptr()->get_whenToSwap() == _64_TDM_) {
-            if ((curCycle())%(64*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        }  else if (get_net_ptr()->get_whenToSwap() == _512_TDM_) {
-            if ((curCycle())%(512*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        }  else if (get_net_ptr()->get_whenToSwap() == _1024_TDM_) {
-            if ((curCycle())%(1024*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        }  else if (get_net_ptr()->get_whenToSwap() == _2048_TDM_) {
-            if ((curCycle())%(2048*(get_net_ptr()->getNumRouters())) == m_id) {
-                return true;
-            } else {
-                return false;
-            }
-
-        }	else {
-            // there has to be some policy on when to Swap.. if control
-            // comes here then there is some problem in above layers
-            assert(0);
-            return false; // to make compiler happy
-        }
-
-    }
-
     RoutingUnit *m_routing_unit;
 
     //uint32_t functionalWrite(Packet *);
@@ -272,6 +191,8 @@ class Router : public BasicRouter, public Consumer
     Cycles m_latency;
     // Cycles print_trigger;
     int m_virtual_networks, m_num_vcs, m_vc_per_vnet;
+    // bit set at the first VC of every vnet
+    uint64_t m_vnet_base_vcs;
     GarnetNetwork *m_network_ptr;
 
     std::vector<InputUnit *> m_input_unit;
@@ -279,6 +200,8 @@ class Router : public BasicRouter, public Consumer
     //RoutingUnit *m_routing_unit;
     SwitchAllocator *m_sw_alloc;
     CrossbarSwitch *m_switch;
+    // NULL unless interswap is enabled
+    SwapTurn *m_swap_turn;
 
     // Statistical variables required for power computations
     Stats::Scalar m_buffer_reads;
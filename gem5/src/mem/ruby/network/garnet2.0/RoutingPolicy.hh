@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGPOLICY_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGPOLICY_HH__
+
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
+
+// Routing policies for RoutingUnit::outportComputeWith<Policy>.
+// RoutingUnit::init() binds one of them per router, so the per-flit
+// call is a single indirect call into a body where the policy is
+// inlined. Flits at their destination router never reach a policy.
+
+struct TableRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.lookupRoutingTable(route.vnet, route.dest_ni);
+    }
+};
+
+struct XYRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.outportComputeXY(route, inport, inport_dirn);
+    }
+};
+
+struct TurnModelObliviousRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.outportComputeTurnModelOblivious(route, inport,
+                                                     inport_dirn);
+    }
+};
+
+struct TurnModelAdaptiveRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.outportComputeTurnModelAdaptive(route, inport,
+                                                    inport_dirn);
+    }
+};
+
+struct RandomObliviousRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.outportComputeRandomOblivious(route, inport,
+                                                  inport_dirn);
+    }
+};
+
+// Random oblivious, with VC 0 kept on the oblivious turn model
+struct TurnModelVC0RandomObliviousRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        if (vc == 0)
+            return unit.outportComputeTurnModelOblivious(route, inport,
+                                                         inport_dirn);
+        return unit.outportComputeRandomOblivious(route, inport,
+                                                  inport_dirn);
+    }
+};
+
+// Minimal adaptive, with an XY escape VC per vnet
+struct RandomAdaptiveRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.outportComputeRandomAdaptive(route, inport,
+                                                 inport_dirn, vc);
+    }
+};
+
+// Het_meshs chiplet routing, configured by the RoutingVariant
+struct ChipletRouting
+{
+    static inline int
+    outport(RoutingUnit &unit, const RouteInfo &route, int inport,
+            PortDirn inport_dirn, int vc)
+    {
+        return unit.outportComputeCustom(route, inport, inport_dirn, vc);
+    }
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGPOLICY_HH__
@@ -33,10 +33,13 @@
 
 #include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
 
+#include <algorithm>
+
 #include "base/cast.hh"
 #include "base/logging.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/RoutingPolicy.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
 #include "mem/ruby/network/garnet2.0/OutputUnit.hh"
@@ -45,11 +48,18 @@
 RoutingUnit::RoutingUnit(Router *router)
 {
     m_router = router;
+    m_layout = NULL;
+    m_coords = NULL;
+    m_turn_row = NULL;
+    m_escape_vc = false;
+    m_sideband = NULL;
     m_routing_table.clear();
     m_weight_table.clear();
 
-	
-
+    for (int dirn = 0; dirn < MAX_PORT_DIRN_; dirn++) {
+        m_inports_dirn2idx[dirn] = INVALID_PORT_;
+        m_outports_dirn2idx[dirn] = INVALID_PORT_;
+    }
 }
 
 void
@@ -69,45 +79,59 @@ RoutingUnit::addWeight(int link_weight)
  * The routing table is populated during topology creation.
  * Routes can be biased via weight assignments in the topology file.
  * Correct weight assignments are critical to provide deadlock avoidance.
+ *
+ * The table does not depend on the vnet, so each destination node gets
+ * one list of its minimum weight output links, kept in link order.
  */
 
-int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+void
+RoutingUnit::buildDestinationTable(int num_nodes)
 {
-    // First find all possible output link candidates
-    // For ordered vnet, just choose the first
-    // (to make sure different packets don't choose different routes)
-    // For unordered vnet, randomly choose any of the links
-    // To have a strict ordering between links, they should be given
-    // different weights in the topology file
-
-    int output_link = -1;
-    int min_weight = INFINITE_;
-    std::vector<int> output_link_candidates;
-    int num_candidates = 0;
+    std::vector<int> min_weight(num_nodes, INFINITE_);
+    std::vector<std::vector<int> > candidates(num_nodes);
 
-    // Identify the minimum weight among the candidate output links
     for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
-
-        if (m_weight_table[link] <= min_weight)
-            min_weight = m_weight_table[link];
+        std::vector<NodeID> dests = m_routing_table[link].getAllDest();
+        for (int i = 0; i < dests.size(); i++) {
+            NodeID dest = dests[i];
+            assert(dest < num_nodes);
+
+            if (m_weight_table[link] < min_weight[dest]) {
+                min_weight[dest] = m_weight_table[link];
+                candidates[dest].clear();
+            }
+            if (m_weight_table[link] == min_weight[dest])
+                candidates[dest].push_back(link);
         }
     }
 
-    // Collect all candidate output links with this minimum weight
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
+    m_dest_offset.assign(num_nodes + 1, 0);
+    m_dest_outports.clear();
+    for (int dest = 0; dest < num_nodes; dest++) {
+        m_dest_offset[dest] = m_dest_outports.size();
+        m_dest_outports.insert(m_dest_outports.end(),
+                               candidates[dest].begin(),
+                               candidates[dest].end());
+    }
+    m_dest_offset[num_nodes] = m_dest_outports.size();
 
-            if (m_weight_table[link] == min_weight) {
+    m_rng.init(m_router->get_id());
+}
 
-                num_candidates++;
-                output_link_candidates.push_back(link);
-            }
-        }
-    }
+int
+RoutingUnit::lookupRoutingTable(int vnet, int dest_ni)
+{
+    // For ordered vnet, just choose the first
+    // (to make sure different packets don't choose different routes)
+    // For unordered vnet, randomly choose any of the links
+    // To have a strict ordering between links, they should be given
+    // different weights in the topology file
+    assert(dest_ni >= 0 && dest_ni + 1 < m_dest_offset.size());
+
+    int first = m_dest_offset[dest_ni];
+    int num_candidates = m_dest_offset[dest_ni + 1] - first;
 
-    if (output_link_candidates.size() == 0) {
+    if (num_candidates == 0) {
         fatal("Fatal Error:: No Route exists from this Router.");
         exit(0);
     }
@@ -115,161 +139,222 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
     // Randomly select any candidate output link
     int candidate = 0;
     if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+        candidate = m_rng.random<int>(0, num_candidates - 1);
 
-    output_link = output_link_candidates.at(candidate);
-    return output_link;
+    return m_dest_outports[first + candidate];
 }
 
 
 void
-RoutingUnit::addInDirection(PortDirection inport_dirn, int inport_idx)
+RoutingUnit::addInDirection(PortDirn inport_dirn, int inport_idx)
 {
+    assert(inport_dirn >= 0 && inport_dirn < MAX_PORT_DIRN_);
+    if (inport_idx >= m_inports_idx2dirn.size())
+        m_inports_idx2dirn.resize(inport_idx + 1, UNKNOWN_DIRN_);
+
     m_inports_dirn2idx[inport_dirn] = inport_idx;
     m_inports_idx2dirn[inport_idx]  = inport_dirn;
 }
 
 void
-RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
+RoutingUnit::addOutDirection(PortDirn outport_dirn, int outport_idx)
 {
+    assert(outport_dirn >= 0 && outport_dirn < MAX_PORT_DIRN_);
+    if (outport_idx >= m_outports_idx2dirn.size())
+        m_outports_idx2dirn.resize(outport_idx + 1, UNKNOWN_DIRN_);
+
     m_outports_dirn2idx[outport_dirn] = outport_idx;
     m_outports_idx2dirn[outport_idx]  = outport_dirn;
 }
 
-// outportCompute() is called by the InputUnit
-// It calls the routing table by default.
-// A template for adaptive topology-specific routing algorithm
-// implementations using port directions rather than a static routing
-// table is provided here.
+bool
+RoutingUnit::outportHasFreeVC(PortDirn dirn, int vnet)
+{
+    int outport = findOutport(dirn);
+    if (outport == INVALID_PORT_)
+        return false;
+    return m_router->get_outputUnit_ref()[outport]->has_free_vc(vnet);
+}
 
+// Settings of the routing knobs for each RoutingVariant, in enum order.
+// The variants used to be separate copies of this file.
+static const RoutingVariantConfig routing_variants[NUM_ROUTING_VARIANT_] = {
+    // ISWAP_ROUTING_
+    { false, false, INTERPOSER_RANDOM_OBLIVIOUS_,
+      INTERPOSER_RANDOM_OBLIVIOUS_, true, INTERPOSER_XY_, false },
+    // DEADLOCK_CHECK_ROUTING_
+    { false, true, INTERPOSER_XY_, INTERPOSER_XY_, true, INTERPOSER_XY_,
+      false },
+    // COMPOSABLE_ROUTING_
+    { true, false, INTERPOSER_XY_, INTERPOSER_XY_, true, INTERPOSER_XY_,
+      false },
+    // BP_ROUTING_
+    { false, true, INTERPOSER_XY_, INTERPOSER_RANDOM_OBLIVIOUS_, false,
+      INTERPOSER_XY_, false },
+    // WRKN_ROUTING_
+    { true, false, INTERPOSER_RANDOM_OBLIVIOUS_,
+      INTERPOSER_RANDOM_OBLIVIOUS_, false, INTERPOSER_XY_, false },
+    // DUATO_ROUTING_: deadlock avoidance baseline, fully adaptive with
+    // an XY escape VC
+    { false, false, INTERPOSER_RANDOM_ADAPTIVE_,
+      INTERPOSER_RANDOM_ADAPTIVE_, false, INTERPOSER_RANDOM_ADAPTIVE_,
+      true },
+};
+
+// Entry point bound by init() for one routing policy. Flits that have
+// reached their router go out of the Local port picked from the table:
+// multiple NIs may be connected to this router, all with output port
+// direction = "Local".
+template <class Policy>
 int
-RoutingUnit::outportCompute(RouteInfo route, int inport,
-                            PortDirection inport_dirn,
-                            int vc)
+RoutingUnit::outportComputeWith(const RouteInfo &route, int inport,
+                                PortDirn inport_dirn, int vc)
 {
-    int outport = -1;
+    if (route.dest_router == m_router->get_id())
+        return lookupRoutingTable(route.vnet, route.dest_ni);
 
-    if (route.dest_router == m_router->get_id()) {
+    int outport = Policy::outport(*this, route, inport, inport_dirn, vc);
+    assert(outport != -1);
+    return outport;
+}
 
-        // Multiple NIs may be connected to this router,
-        // all with output port direction = "Local"
-        // Get exact outport id from table
-        outport = lookupRoutingTable(route.vnet, route.net_dest);
-        return outport;
-    }
+// Routing Algorithm set in GarnetNetwork.py
+// Can be over-ridden from command line using --routing-algorithm = 1
+// The policy is bound once per router, so outportCompute() does not
+// look at the algorithm again.
+void
+RoutingUnit::init()
+{
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
+    m_variant = routing_variants[net_ptr->getRoutingVariant()];
+    m_vc_per_vnet = m_router->get_vc_per_vnet();
+    m_sideband = net_ptr->getCongestionSideband();
 
-    // Routing Algorithm set in GarnetNetwork.py
-    // Can be over-ridden from command line using --routing-algorithm = 1
     RoutingAlgorithm routing_algorithm =
-        (RoutingAlgorithm) m_router->get_net_ptr()->getRoutingAlgorithm();
+        (RoutingAlgorithm) net_ptr->getRoutingAlgorithm();
+
+    // Coordinates of every router, and of this one, for the direction
+    // based algorithms
+    const std::vector<RouterCoord> &coords = net_ptr->getRouterCoords();
+    m_coords = coords.data();
+    m_coord = coords[m_router->get_id()];
+    if (routing_algorithm != TABLE_ &&
+        routing_algorithm < NUM_ROUTING_ALGORITHM_ && m_coord.x < 0)
+        fatal("Routing algorithm %d needs num_rows or a chiplet layout\n",
+              routing_algorithm);
+
+    // false if the outport depends on the VC or on router state
+    bool oblivious = true;
 
     switch (routing_algorithm) {
-        case TABLE_:  outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
-        case XY_:     outport =
-            outportComputeXY(route, inport, inport_dirn); break;
-        case TURN_MODEL_OBLIVIOUS_: outport =
-            outportComputeTurnModelOblivious(route, inport, inport_dirn); break;
-        //case TURN_MODEL_ADAPTIVE_: outport =
-        //    outportComputeTurnModelAdaptive(route, inport, inport_dirn); break;
-        case TURN_MODEL_ADAPTIVE_: outport =
-            outportComputeTurnModelAdaptive(route, inport, inport_dirn); break;
-		//case RANDOM_OBLIVIOUS_: outport =
-        //    outportComputeRandomOblivious(route, inport, inport_dirn); break;
-        case RANDOM_OBLIVIOUS_: outport = (vc==0) ? outportComputeTurnModelOblivious(route, inport, inport_dirn): outportComputeRandomOblivious(route, inport, inport_dirn); break;
-		case RANDOM_ADAPTIVE_: outport =
-            outportComputeRandomAdaptive(route, inport, inport_dirn); break;
+        case XY_: m_outport_compute =
+            &RoutingUnit::outportComputeWith<XYRouting>; break;
+        case TURN_MODEL_OBLIVIOUS_: m_outport_compute =
+            &RoutingUnit::outportComputeWith<TurnModelObliviousRouting>;
+            m_turn_row = net_ptr->getTurnModel().routerRow(m_router->get_id());
+            break;
+        case TURN_MODEL_ADAPTIVE_: m_outport_compute =
+            &RoutingUnit::outportComputeWith<TurnModelAdaptiveRouting>;
+            m_turn_row = net_ptr->getTurnModel().routerRow(m_router->get_id());
+            oblivious = false;
+            break;
+        case RANDOM_OBLIVIOUS_:
+            if (m_variant.turn_model_vc0) {
+                m_outport_compute = &RoutingUnit::outportComputeWith<
+                    TurnModelVC0RandomObliviousRouting>;
+                m_turn_row =
+                    net_ptr->getTurnModel().routerRow(m_router->get_id());
+                oblivious = false;
+            } else
+                m_outport_compute = &RoutingUnit::outportComputeWith<
+                    RandomObliviousRouting>;
+            break;
+        case RANDOM_ADAPTIVE_: m_outport_compute =
+            &RoutingUnit::outportComputeWith<RandomAdaptiveRouting>;
+            if (m_vc_per_vnet < 2)
+                fatal("Random adaptive routing needs an escape VC and at "
+                      "least one adaptive VC per vnet\n");
+            m_escape_vc = true;
+            oblivious = false;
+            break;
         // any custom algorithm
-        case CUSTOM_: outport =
-            outportComputeCustom(route, inport, inport_dirn); break;
-        default: outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+        case CUSTOM_:
+            if (!net_ptr->getChipletLayout().isValid())
+                fatal("Custom routing needs a chiplet layout from the "
+                      "topology\n");
+            m_layout = &net_ptr->getChipletLayout();
+            m_outport_compute =
+                &RoutingUnit::outportComputeWith<ChipletRouting>;
+            oblivious =
+                m_variant.intra_interposer != INTERPOSER_RANDOM_ADAPTIVE_ &&
+                m_variant.transit_interposer != INTERPOSER_RANDOM_ADAPTIVE_ &&
+                m_variant.intra_chiplet != INTERPOSER_RANDOM_ADAPTIVE_ &&
+                !m_variant.escape_vc;
+            if (m_variant.escape_vc) {
+                if (m_vc_per_vnet < 2)
+                    fatal("Routing variant %d needs an escape VC and at "
+                          "least one adaptive VC per vnet\n",
+                          net_ptr->getRoutingVariant());
+                m_escape_vc = true;
+            }
+            break;
+        case TABLE_:
+        default: m_outport_compute =
+            &RoutingUnit::outportComputeWith<TableRouting>; break;
     }
 
-    assert(outport != -1);
-    return outport;
-}	
-     
-// XY routing implemented using port directions
-// Only for reference purpose in a Mesh
-// By default Garnet uses the routing table
-int
-RoutingUnit::outportComputeXY(RouteInfo route,
-                                  int inport,
- 	                             PortDirection inport_dirn)
-{	
-        PortDirection outport_dirn = "Unknown";
- 	
- 	   int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
-        int num_cols = m_router->get_net_ptr()->getNumCols();
- 	   assert(num_rows > 0 && num_cols > 0);
- 	
- 	   int my_id = m_router->get_id();
- 	   int my_x = my_id % num_cols;
- 	   int my_y = my_id / num_cols;
- 	
- 	   int dest_id = route.dest_router;
- 	   int dest_x = dest_id % num_cols;
- 	   int dest_y = dest_id / num_cols;
- 	
- 	   int x_hops = abs(dest_x - my_x);
- 	   int y_hops = abs(dest_y - my_y);
- 	
- 	   bool x_dirn = (dest_x >= my_x);
- 	   bool y_dirn = (dest_y >= my_y);
- 	
- 	   // already checked that in outportCompute() function
- 	   assert(!(x_hops == 0 && y_hops == 0));
- 	
- 	   if (x_hops > 0) {
- 	       if (x_dirn) {
- 	           assert(inport_dirn == "Local" || inport_dirn == "West");
- 	           outport_dirn = "East";
- 	       } else {
-            assert(inport_dirn == "Local" || inport_dirn == "East");
-            outport_dirn = "West";
+    // Source routes are computed once at the NI, with the injection VC
+    // and before the flit reaches any router
+    if (net_ptr->isSourceRouting() && !oblivious)
+        fatal("Source routing needs an oblivious routing algorithm, "
+              "not %d with routing variant %d\n", routing_algorithm,
+              net_ptr->getRoutingVariant());
+}
+
+// Mesh direction helpers on (x, y) coordinates; y grows to the North.
+
+// Dimension-ordered: X first, then Y.
+PortDirn
+RoutingUnit::xyDirn(int my_x, int my_y, int dest_x, int dest_y,
+                    PortDirn inport_dirn)
+{
+    int x_hops = abs(dest_x - my_x);
+    int y_hops = abs(dest_y - my_y);
+
+    bool x_dirn = (dest_x >= my_x);
+    bool y_dirn = (dest_y >= my_y);
+
+    if (x_hops > 0) {
+        if (x_dirn) {
+            assert(inport_dirn == LOCAL_DIRN_ || inport_dirn == WEST_DIRN_);
+            return EAST_DIRN_;
+        } else {
+            assert(inport_dirn == LOCAL_DIRN_ || inport_dirn == EAST_DIRN_);
+            return WEST_DIRN_;
         }
     } else if (y_hops > 0) {
         if (y_dirn) {
             // "Local" or "South" or "West" or "East"
- 	           assert(inport_dirn != "North");
-                outport_dirn = "North";
-            } else {
- 	           // "Local" or "North" or "West" or "East"
-                assert(inport_dirn != "South");
- 	           outport_dirn = "South";
- 	       }
+            assert(inport_dirn != NORTH_DIRN_);
+            return NORTH_DIRN_;
         } else {
- 	       // x_hops == 0 and y_hops == 0
- 	       // this is not possible
-            // already checked that in outportCompute() function
- 	       panic("x_hops == y_hops == 0");
- 	   }
-     
- 	   return m_outports_dirn2idx[outport_dirn];
-}	
- 	
- 	
-int
-RoutingUnit::outportComputeTurnModelOblivious(RouteInfo route,
- 	                                   int inport,
- 	                                   PortDirection inport_dirn)
-{	
- 	
- 	   PortDirection outport_dirn = "Unknown";
- 	
- 	   int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
- 	   int num_cols = m_router->get_net_ptr()->getNumCols();
- 	   assert(num_rows > 0 && num_cols > 0);
- 	
- 	   int my_id = m_router->get_id();
- 	   int my_x = my_id % num_cols;
- 	   int my_y = my_id / num_cols;
- 	
- 	   int dest_id = route.dest_router;
- 	   int dest_x = dest_id % num_cols;
- 	   int dest_y = dest_id / num_cols;
- 	
+            // "Local" or "North" or "West" or "East"
+            assert(inport_dirn != SOUTH_DIRN_);
+            return SOUTH_DIRN_;
+        }
+    }
+
+    // x_hops == 0 and y_hops == 0
+    // this is not possible
+    // already checked that in outportCompute() function
+    panic("x_hops == y_hops == 0");
+    return UNKNOWN_DIRN_;
+}
+
+// Straight line when aligned, otherwise a random minimal direction.
+PortDirn
+RoutingUnit::randomObliviousDirn(int my_x, int my_y, int dest_x, int dest_y)
+{
     int x_hops = abs(dest_x - my_x);
     int y_hops = abs(dest_y - my_y);
 
@@ -279,1260 +364,541 @@ RoutingUnit::outportComputeTurnModelOblivious(RouteInfo route,
     // already checked that in outportCompute() function
     assert(!(x_hops == 0 && y_hops == 0));
 
-    /////////////////////////////////////////
-    // ICN Lab 3: Insert code here
-	if (x_hops == 0)
-    {
-        if (y_dirn > 0)
-            outport_dirn = "North";
-        else
-            outport_dirn = "South";
-    }
-    else if (y_hops == 0)
-    {
-        if (x_dirn > 0)
-            outport_dirn = "East";
-        else
-            outport_dirn = "West";
-    } else {
-        int rand = random() % 2;
-
-        if (x_dirn && y_dirn) // Quadrant I
-            outport_dirn = rand ? "East" : "East";
-        else if (!x_dirn && y_dirn) // Quadrant II
-            outport_dirn = rand ? "West" : "West";
-        else if (!x_dirn && !y_dirn) // Quadrant III
-            outport_dirn = rand ? "West" : "South";
-        else // Quadrant IV
-            outport_dirn = rand ? "East" : "South";
-    }
+    if (x_hops == 0)
+        return y_dirn ? NORTH_DIRN_ : SOUTH_DIRN_;
+    if (y_hops == 0)
+        return x_dirn ? EAST_DIRN_ : WEST_DIRN_;
+
+    int rand = m_rng.random<int>(0, 1);
+
+    if (x_dirn && y_dirn) // Quadrant I
+        return rand ? EAST_DIRN_ : NORTH_DIRN_;
+    else if (!x_dirn && y_dirn) // Quadrant II
+        return rand ? WEST_DIRN_ : NORTH_DIRN_;
+    else if (!x_dirn && !y_dirn) // Quadrant III
+        return rand ? WEST_DIRN_ : SOUTH_DIRN_;
+    else // Quadrant IV
+        return rand ? EAST_DIRN_ : SOUTH_DIRN_;
+}
 
+// Like randomObliviousDirn, but picks the minimal direction with more
+// free adaptive VCs in this vnet, then more credits, then at random. If
+// neither has one it takes the XY direction, where the escape VC may be
+// used. With the congestion sideband, when both have a free VC the one
+// leading into the less congested region wins.
+PortDirn
+RoutingUnit::randomAdaptiveDirn(int my_x, int my_y, int dest_x, int dest_y,
+                                int vnet)
+{
+    int x_hops = abs(dest_x - my_x);
+    int y_hops = abs(dest_y - my_y);
+
+    bool x_dirn = (dest_x >= my_x);
+    bool y_dirn = (dest_y >= my_y);
 
-    return m_outports_dirn2idx[outport_dirn];
+    // already checked that in outportCompute() function
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    if (x_hops == 0)
+        return y_dirn ? NORTH_DIRN_ : SOUTH_DIRN_;
+    if (y_hops == 0)
+        return x_dirn ? EAST_DIRN_ : WEST_DIRN_;
+
+    PortDirn x_out = x_dirn ? EAST_DIRN_ : WEST_DIRN_;
+    PortDirn y_out = y_dirn ? NORTH_DIRN_ : SOUTH_DIRN_;
+
+    // x_out is the XY direction. Neither is scored with the escape VC,
+    // which is only offered last, on x_out.
+    int score_x = outportScore(x_out, vnet, false);
+    int score_y = outportScore(y_out, vnet, false);
+
+    if (score_x < FREE_VC_SCORE_ && score_y < FREE_VC_SCORE_)
+        return x_out;
+    if (score_x >= FREE_VC_SCORE_ && score_y >= FREE_VC_SCORE_) {
+        int regional = regionalCompare(x_out, y_out);
+        if (regional != 0)
+            return (regional < 0) ? x_out : y_out;
+    }
+    if (score_x != score_y)
+        return (score_x > score_y) ? x_out : y_out;
+    return m_rng.random<int>(0, 1) ? y_out : x_out;
 }
 
+// Free VCs of outport 'dirn' in 'vnet' (FREE_VC_SCORE_ each) plus the
+// credits left in its VCs; -1 if there is no such outport. The escape
+// VC is only counted with escape_ok.
 int
-RoutingUnit::outportComputeTurnModelAdaptive(RouteInfo route,
-                                    int inport,
-                                    PortDirection inport_dirn)
+RoutingUnit::outportScore(PortDirn dirn, int vnet, bool escape_ok)
 {
+    int outport = findOutport(dirn);
+    if (outport == INVALID_PORT_)
+        return -1;
+
+    OutputUnit *output_unit = m_router->get_outputUnit_ref()[outport];
+    uint64_t free_vcs = output_unit->get_free_vcs(vnet);
+    if (m_escape_vc && !escape_ok)
+        free_vcs &= ~escapeVC(vnet);
 
-   PortDirection outport_dirn = "Unknown";
+    int credits = 0;
+    int base = vnet * m_vc_per_vnet;
+    for (int vc = base; vc < base + m_vc_per_vnet; vc++)
+        credits += output_unit->get_credit_count(vc);
 
-    int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
-    int num_cols = m_router->get_net_ptr()->getNumCols();
-    assert(num_rows > 0 && num_cols > 0);
+    return popCount(free_vcs) * FREE_VC_SCORE_ + credits;
+}
 
+int
+RoutingUnit::regionalCompare(PortDirn a, PortDirn b)
+{
+    if (m_sideband == NULL)
+        return 0;
     int my_id = m_router->get_id();
-    int my_x = my_id % num_cols;
-    int my_y = my_id / num_cols;
+    return m_sideband->congestion(my_id, a) -
+           m_sideband->congestion(my_id, b);
+}
 
-    int dest_id = route.dest_router;
-    int dest_x = dest_id % num_cols;
-    int dest_y = dest_id / num_cols;
+// The escape VC is only handed out on the escape path (XY on a mesh),
+// so flits in it stay on a deadlock free network.
+bool
+RoutingUnit::escapeVCAllowed(const RouteInfo &route, PortDirn outport_dirn)
+{
+    if (outport_dirn == LOCAL_DIRN_ ||
+        route.dest_router == m_router->get_id())
+        return true;
 
-    int x_hops = abs(dest_x - my_x);
-    int y_hops = abs(dest_y - my_y);
+    return outport_dirn == escapeDirn(route);
+}
 
-    bool x_dirn = (dest_x >= my_x);
-    bool y_dirn = (dest_y >= my_y);
+int
+RoutingUnit::escapeOutport(const RouteInfo &route)
+{
+    if (route.dest_router == m_router->get_id())
+        return -1;
+    return outportIdx(escapeDirn(route));
+}
 
-    // already checked that in outportCompute() function
-    assert(!(x_hops == 0 && y_hops == 0));
+PortDirn
+RoutingUnit::escapeDirn(const RouteInfo &route)
+{
+    if (m_layout != NULL)
+        return chipletEscapeDirn(route);
 
-    if (x_hops == 0)
-    {
-        if (y_dirn > 0)
-            outport_dirn = "North";
-        else
-            outport_dirn = "South";
+    const RouterCoord &dest = m_coords[route.dest_router];
+    return xyDirn(m_coord.x, m_coord.y, dest.x, dest.y, LOCAL_DIRN_);
+}
+
+// Escape path of the chiplet routing: XY within each region, through
+// the first boundary of the source and of the destination chiplet. On
+// a chiplet, the XY paths to and from that one boundary router use
+// disjoint channels, so no escape channel on the way in depends on one
+// on the way out and the escape network is free of cycles across the
+// interposer.
+PortDirn
+RoutingUnit::chipletEscapeDirn(const RouteInfo &route)
+{
+    const ChipletLayout &layout = *m_layout;
+    int interposer = layout.interposer();
+    int my_id = m_router->get_id();
+    int dest_mesh = m_coords[route.dest_router].region;
+
+    int target = route.dest_router;
+    PortDirn exit_dirn = UNKNOWN_DIRN_;
+    if (m_coord.region != dest_mesh) {
+        if (m_coord.region != interposer) {
+            const ChipletLayout::Boundary &b =
+                layout.boundary(m_coord.region, 0);
+            target = b.router;
+            exit_dirn = b.down;
+        } else {
+            const ChipletLayout::Boundary &b = layout.boundary(dest_mesh, 0);
+            target = b.interposer_router;
+            exit_dirn = b.up;
+        }
     }
-    else if (y_hops == 0)
-    {
-        if (x_dirn > 0)
-            outport_dirn = "East";
-        else
-            outport_dirn = "West";
-    } else {
-        int rand = random() % 2;
-
-		bool freeVC_E =0;
-		bool freeVC_S =0;
-		bool freeVC_W =0;
-		
-		m_input_unit = m_router->get_inputUnit_ref();
-    	m_output_unit = m_router->get_outputUnit_ref();
-
-		freeVC_E = 	m_output_unit[m_outports_dirn2idx["East"]]->has_free_vc(route.vnet);
-		freeVC_S = 	m_output_unit[m_outports_dirn2idx["South"]]->has_free_vc(route.vnet);
-		freeVC_W = 	m_output_unit[m_outports_dirn2idx["West"]]->has_free_vc(route.vnet);
-		
-		if (x_dirn && y_dirn) { // Quadrant I
-				outport_dirn = "East";
-		} else if (!x_dirn && y_dirn) { // Quadrant II
-				outport_dirn = "West";
-		} else if (!x_dirn && !y_dirn) { // Quadrant III
-        	if (freeVC_W & freeVC_S) {
-				outport_dirn = rand ? "West" : "South";
-			} else if (freeVC_S) {
-				outport_dirn = "South";
-			} else if (freeVC_W) {
-				outport_dirn = "West";
-			} else {
-				outport_dirn = rand ? "West" : "South";
-			}
-		
-		} else {// Quadrant IV
-        	if (freeVC_E & freeVC_S) {
-				outport_dirn = rand ? "East" : "South";
-			} else if (freeVC_S) {
-				outport_dirn = "South";
-			} else if (freeVC_E) {
-				outport_dirn = "East";
-			} else {
-				outport_dirn = rand ? "East" : "South";
-			}
-		}
 
+    if (my_id == target) {
+        assert(exit_dirn != UNKNOWN_DIRN_);
+        return exit_dirn;
     }
- 
-	return m_outports_dirn2idx[outport_dirn];
+    const RouterCoord &t = m_coords[target];
+    return xyDirn(m_coord.x, m_coord.y, t.x, t.y, LOCAL_DIRN_);
+}
+
+void
+RoutingUnit::enterEscape(RouteInfo &route)
+{
+    if (m_layout == NULL)
+        return;
+
+    int interposer = m_layout->interposer();
+    int my_mesh = m_coord.region;
+    int dest_mesh = m_coords[route.dest_router].region;
+    if (my_mesh != dest_mesh && my_mesh != interposer)
+        route.egress_boundary = 0;
+    if (my_mesh != dest_mesh && dest_mesh != interposer)
+        route.ingress_boundary = 0;
 }
 
+PortDirn
+RoutingUnit::regionDirn(InterposerRouting algo, int my_id, int dest_id,
+                        int vnet, PortDirn inport_dirn)
+{
+    int my_x = m_coords[my_id].x, my_y = m_coords[my_id].y;
+    int dest_x = m_coords[dest_id].x, dest_y = m_coords[dest_id].y;
+
+    switch (algo) {
+        case INTERPOSER_RANDOM_OBLIVIOUS_:
+            return randomObliviousDirn(my_x, my_y, dest_x, dest_y);
+        case INTERPOSER_RANDOM_ADAPTIVE_:
+            return randomAdaptiveDirn(my_x, my_y, dest_x, dest_y, vnet);
+        case INTERPOSER_XY_:
+        default:
+            return xyDirn(my_x, my_y, dest_x, dest_y, inport_dirn);
+    }
+}
 
+// XY routing implemented using port directions
+// Only for reference purpose in a Mesh
+// By default Garnet uses the routing table
 int
-RoutingUnit::outportComputeRandomOblivious(RouteInfo route,
+RoutingUnit::outportComputeXY(const RouteInfo &route,
                               int inport,
-                              PortDirection inport_dirn)
+                              PortDirn inport_dirn)
 {
-    PortDirection outport_dirn = "Unknown";
+    const RouterCoord &dest = m_coords[route.dest_router];
 
-    int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
-    int num_cols = m_router->get_net_ptr()->getNumCols();
-    assert(num_rows > 0 && num_cols > 0);
-
-    int my_id = m_router->get_id();
-    int my_x = my_id % num_cols;
-    int my_y = my_id / num_cols;
+    return outportIdx(xyDirn(m_coord.x, m_coord.y, dest.x, dest.y,
+                             inport_dirn));
+}
 
-    int dest_id = route.dest_router;
-    int dest_x = dest_id % num_cols;
-    int dest_y = dest_id / num_cols;
+// Turn model routing on the tables of GarnetNetwork's TurnModel: among
+// the minimal outports that keep the destination reachable without a
+// prohibited turn, the oblivious version picks at random and the
+// adaptive one by free VCs and credits.
+int
+RoutingUnit::outportComputeTurnModel(const RouteInfo &route,
+                                     PortDirn inport_dirn, bool adaptive)
+{
+    // the flit travels away from the inport it came in by
+    static const PortDirn travel[NUM_MESH_DIRN_] =
+        { LOCAL_DIRN_, SOUTH_DIRN_, WEST_DIRN_, NORTH_DIRN_, EAST_DIRN_ };
+    int in = (inport_dirn >= 0 && inport_dirn < NUM_MESH_DIRN_) ?
+        travel[inport_dirn] : LOCAL_DIRN_;
+
+    const uint8_t *entry = &m_turn_row[route.dest_router * NUM_MESH_DIRN_];
+    uint64_t allowed = entry[in];
+    // iSWAP can put a flit on an inport it could not have come in by;
+    // route it as if it were injected here
+    if (allowed == 0)
+        allowed = entry[LOCAL_DIRN_];
+    assert(allowed != 0);
+
+    PortDirn first = (PortDirn) findLsbSet(allowed);
+    if (allowed == (1ULL << first))
+        return outportIdx(first);
+
+    PortDirn second = (PortDirn) findMsbSet(allowed);
+    bool first_is_x = (first == EAST_DIRN_ || first == WEST_DIRN_);
+    PortDirn x_out = first_is_x ? first : second;
+    PortDirn y_out = first_is_x ? second : first;
+
+    if (adaptive) {
+        int score_x = outportScore(x_out, route.vnet, true);
+        int score_y = outportScore(y_out, route.vnet, true);
+        if (score_x >= FREE_VC_SCORE_ && score_y >= FREE_VC_SCORE_) {
+            int regional = regionalCompare(x_out, y_out);
+            if (regional != 0)
+                return outportIdx((regional < 0) ? x_out : y_out);
+        }
+        if (score_x != score_y)
+            return outportIdx((score_x > score_y) ? x_out : y_out);
+    }
 
-    int x_hops = abs(dest_x - my_x);
-    int y_hops = abs(dest_y - my_y);
+    return outportIdx(m_rng.random<int>(0, 1) ? x_out : y_out);
+}
 
-    bool x_dirn = (dest_x >= my_x);
-    bool y_dirn = (dest_y >= my_y);
+int
+RoutingUnit::outportComputeTurnModelOblivious(const RouteInfo &route,
+                                              int inport,
+                                              PortDirn inport_dirn)
+{
+    return outportComputeTurnModel(route, inport_dirn, false);
+}
 
-    // already checked that in outportCompute() function
-    assert(!(x_hops == 0 && y_hops == 0));
+int
+RoutingUnit::outportComputeTurnModelAdaptive(const RouteInfo &route,
+                                             int inport,
+                                             PortDirn inport_dirn)
+{
+    return outportComputeTurnModel(route, inport_dirn, true);
+}
 
-    if (x_hops == 0)
-    {
-        if (y_dirn > 0)
-            outport_dirn = "North";
-        else
-            outport_dirn = "South";
-    }
-    else if (y_hops == 0)
-    {
-        if (x_dirn > 0)
-            outport_dirn = "East";
-        else
-            outport_dirn = "West";
-    } else {
-        int rand = random() % 2;
-
-        if (x_dirn && y_dirn) // Quadrant I
-            outport_dirn = rand ? "East" : "North";
-        else if (!x_dirn && y_dirn) // Quadrant II
-            outport_dirn = rand ? "West" : "North";
-        else if (!x_dirn && !y_dirn) // Quadrant III
-            outport_dirn = rand ? "West" : "South";
-        else // Quadrant IV
-            outport_dirn = rand ? "East" : "South";
-    }
+int
+RoutingUnit::outportComputeRandomOblivious(const RouteInfo &route,
+                              int inport,
+                              PortDirn inport_dirn)
+{
+    const RouterCoord &dest = m_coords[route.dest_router];
 
-    return m_outports_dirn2idx[outport_dirn];
+    return outportIdx(randomObliviousDirn(m_coord.x, m_coord.y,
+                                          dest.x, dest.y));
 }
 
+// Minimal adaptive routing. The first VC of each vnet is an escape VC
+// routed XY; the others pick between the productive directions by
+// free VCs and credits (see randomAdaptiveDirn).
 int
-RoutingUnit::outportComputeRandomAdaptive(RouteInfo route,
+RoutingUnit::outportComputeRandomAdaptive(const RouteInfo &route,
                               int inport,
-                              PortDirection inport_dirn)
+                              PortDirn inport_dirn,
+                              int vc)
 {
-    panic("%s placeholder executed", __FUNCTION__);
+    const RouterCoord &dest = m_coords[route.dest_router];
+
+    // a flit may reach the escape VC through a swap, so the turn
+    // checks of XY do not hold here
+    if (vc % m_vc_per_vnet == 0)
+        return outportIdx(xyDirn(m_coord.x, m_coord.y, dest.x, dest.y,
+                                 LOCAL_DIRN_));
+
+    return outportIdx(randomAdaptiveDirn(m_coord.x, m_coord.y,
+                                         dest.x, dest.y, route.vnet));
 }
 
-// Template for implementing custom routing algorithm
-// using port directions. (Example adaptive)
+
+// Routing for chiplet systems, on the ChipletLayout given by the
+// topology (e.g. Het_meshs: three 4x4 chiplets on a 4x4 interposer).
+//  1. src and dest in the same region: route within it.
+//  2. otherwise: XY to a boundary router of the source chiplet, down to
+//     the interposer, across it to the router under a boundary router
+//     of the destination chiplet, up, and XY to the destination.
+// The boundaries are fixed at injection (selectBoundaries); the knobs
+// of each step come from the RoutingVariant. With an escape VC, flits
+// in it take chipletEscapeDirn instead. With an interposer
+// intermediate, the interposer leg goes XY to it and then XY on.
 int
-RoutingUnit::outportComputeCustom(RouteInfo route,
+RoutingUnit::outportComputeCustom(const RouteInfo &route,
                                  int inport,
-                                 PortDirection inport_dirn)
+                                 PortDirn inport_dirn,
+                                 int vc)
 {
+    if (m_escape_vc && vc % m_vc_per_vnet == 0)
+        return outportIdx(chipletEscapeDirn(route));
 
-//1. if src dest within the sub-meshes, implement XY within them (use modulo).
+    const ChipletLayout &layout = *m_layout;
+    int interposer = layout.interposer();
 
-//2. if src dest across sub-meshes. Route to the nearest boundary router using sum of xy hops. Enable all turns to interposer from all boundary routers. This should create a valid path to destination. But may involve deadlocks. 
+    int my_id = m_router->get_id();
+    int dest_id = route.dest_router;
+    int src_id = route.src_router;
 
-//write a python script to identify illegal turns, using this remove the turns, manually here for 2nd case
+    const RouterCoord &dest = m_coords[dest_id];
 
-//This should implement all of modular routing paper except for boundary router position.
+    int my_mesh = m_coord.region;
+    int dest_mesh = dest.region;
+    int src_mesh = m_coords[src_id].region;
 
-//see if you can control uniform random traffic here: src/cpu/testers/garnet_synthetic_traffic/GarnetSyntheticTraffic.cc
+    PortDirn outport_dirn = UNKNOWN_DIRN_;
 
-    //panic("%s placeholder executed", __FUNCTION__);
-	PortDirection outport_dirn = "Unknown";
-    //int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
-    //int num_cols = m_router->get_net_ptr()->getNumCols();
-   	int M5_VAR_USED num_rows = 4;
-    int num_cols = 4;
-	assert(num_rows > 0 && num_cols > 0);
-	
-	int my_id = m_router->get_id();
-    int dest_id = route.dest_router;
-	int src_id = route.src_router;
-    
-	
-
-
-	bool use_random_adaptive;
-	bool use_random_oblivious;
-	bool use_src_index_in_src_chiplet;
-	bool interposer_deflect;
-
-	bool iSWAP_enable =1;
-	bool deadlock_check =0;
-    bool composable = 0;
-
-	if (iSWAP_enable) 
-	{
-		use_random_adaptive = 0;
-		use_random_oblivious = 1;
-		use_src_index_in_src_chiplet = 0;
-		interposer_deflect = 0;
-	} else if (deadlock_check) {
-		use_random_adaptive = 0;
-		use_random_oblivious = 0;
-		use_src_index_in_src_chiplet = 0;
-		interposer_deflect = 1;	
-	} else if (composable) {
-		use_random_adaptive = 0;
-		use_random_oblivious = 0;
-		use_src_index_in_src_chiplet = 1;
-		interposer_deflect = 0;
-	}
-
-	
-	int id_for_route;
-
-	if (use_src_index_in_src_chiplet) {
-	  	id_for_route = src_id;
-	} else {
-		id_for_route = dest_id;
+    // first phase of two-phase interposer routing, XY on the way to
+    // the intermediate and from it
+    if (my_mesh == interposer && route.intermediate != -1) {
+        int target = route.intermediate;
+        if (route.intermediate_reached) {
+            target = dest_id;
+            if (dest_mesh != interposer)
+                target = layout.boundary(dest_mesh,
+                    route.ingress_boundary).interposer_router;
+        }
+        if (my_id != target)
+            return outportIdx(regionDirn(INTERPOSER_XY_, my_id, target,
+                                         route.vnet, LOCAL_DIRN_));
+    }
+
+    if (my_mesh == dest_mesh && my_mesh == src_mesh) {
+        if (my_mesh != interposer)
+            outport_dirn = regionDirn(m_variant.intra_chiplet, my_id,
+                                      dest_id, route.vnet, inport_dirn);
+        else
+            outport_dirn = regionDirn(m_variant.intra_interposer, my_id,
+                                      dest_id, route.vnet, inport_dirn);
+
+    } else if (my_mesh == src_mesh && my_mesh != interposer) {
+        /* source chiplet to interposer */
+        assert(route.egress_boundary != -1);
+        const ChipletLayout::Boundary &b =
+            layout.boundary(my_mesh, route.egress_boundary);
+
+        if (my_id == b.router)
+            outport_dirn = b.down;
+        else
+            outport_dirn = regionDirn(m_variant.intra_chiplet, my_id,
+                                      b.router, route.vnet, inport_dirn);
+
+    } else if (my_mesh == interposer) {
+        /* interposer routing */
+        int target = dest_id;
+        PortDirn up = UNKNOWN_DIRN_;
+        if (dest_mesh != interposer) {
+            assert(route.ingress_boundary != -1);
+            const ChipletLayout::Boundary &b =
+                layout.boundary(dest_mesh, route.ingress_boundary);
+            target = b.interposer_router;
+            up = b.up;
+        }
+
+        if (my_id == target) {
+            assert(dest_mesh != interposer);
+            outport_dirn = up;
+        } else {
+            outport_dirn = regionDirn(m_variant.transit_interposer,
+                                      my_id, target, route.vnet,
+                                      LOCAL_DIRN_);
+        }
+
+    } else {
+        /* interposer to destination chiplet */
+        outport_dirn = regionDirn(m_variant.intra_chiplet, my_id, dest_id,
+                                  route.vnet, LOCAL_DIRN_);
+    }
+
+    return outportIdx(outport_dirn);
+}
+
+// Picks the boundaries once per packet, on the source router's
+// RoutingUnit, so every router on the way agrees on them. The static
+// hash takes router id modulo the chiplet's number of boundaries: the
+// source or destination id as the variant says on the way down, the
+// destination id on the way up (rotated by half on deflecting
+// variants).
+void
+RoutingUnit::selectBoundaries(RouteInfo &route)
+{
+    route.egress_boundary = -1;
+    route.ingress_boundary = -1;
+    if (m_layout == NULL)
+        return;
+
+    const ChipletLayout &layout = *m_layout;
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
+    int interposer = layout.interposer();
+    int src_mesh = m_coords[route.src_router].region;
+    int dest_mesh = m_coords[route.dest_router].region;
+
+    if (src_mesh == dest_mesh)
+        return;
+
+    if (src_mesh != interposer) {
+        int key = m_variant.boundary_by_src ? route.src_router
+                                            : route.dest_router;
+        int idx = key % layout.numBoundaries(src_mesh);
+        idx = pickBoundary(src_mesh, idx, route.vnet, true);
+
+        route.egress_boundary = idx;
+        net_ptr->increment_boundary_egress(
+            layout.boundary(src_mesh, idx).index);
+    }
+
+    if (dest_mesh != interposer) {
+        int num_boundaries = layout.numBoundaries(dest_mesh);
+        int idx = route.dest_router % num_boundaries;
+        if (m_variant.interposer_deflect)
+            idx = (idx + num_boundaries / 2) % num_boundaries;
+        idx = pickBoundary(dest_mesh, idx, route.vnet, false);
+
+        route.ingress_boundary = idx;
+        net_ptr->increment_boundary_ingress(
+            layout.boundary(dest_mesh, idx).index);
     }
+}
 
+// Valiant takes any interposer router, ROMM one in the rectangle
+// between the routers the packet enters and leaves the interposer by.
+void
+RoutingUnit::selectIntermediate(RouteInfo &route)
+{
+    if (m_layout == NULL)
+        return;
+
+    const ChipletLayout &layout = *m_layout;
+    int interposer = layout.interposer();
+    int src_mesh = m_coords[route.src_router].region;
+    int dest_mesh = m_coords[route.dest_router].region;
+    if (src_mesh == dest_mesh && src_mesh != interposer)
+        return;
+
+    int entry = route.src_router;
+    if (src_mesh != interposer)
+        entry = layout.boundary(src_mesh,
+                                route.egress_boundary).interposer_router;
+    int exit = route.dest_router;
+    if (dest_mesh != interposer)
+        exit = layout.boundary(dest_mesh,
+                               route.ingress_boundary).interposer_router;
+
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
+    if (net_ptr->getInterposerIntermediate() == VALIANT_INTERMEDIATE_) {
+        const std::vector<int> &routers = layout.routers(interposer);
+        route.intermediate =
+            routers[m_rng.random<int>(0, routers.size() - 1)];
+    } else {
+        const RouterCoord &a = m_coords[entry];
+        const RouterCoord &b = m_coords[exit];
+        int x = m_rng.random<int>(std::min(a.x, b.x), std::max(a.x, b.x));
+        int y = m_rng.random<int>(std::min(a.y, b.y), std::max(a.y, b.y));
+        route.intermediate = layout.routerAt(interposer, x, y);
+        // a hole in the interposer mesh: go minimal
+        if (route.intermediate == -1)
+            route.intermediate = entry;
+    }
+}
 
-	if ((dest_id < 16) && (src_id <16) && (my_id <16) ) { /* chiplet 1 x-y routing */
-		
-		int my_x = my_id % num_cols;
-   		int my_y = my_id / num_cols;
-
-	    int dest_x = dest_id % num_cols;
-    	int dest_y = dest_id / num_cols;
-
-    	int x_hops = abs(dest_x - my_x);
-    	int y_hops = abs(dest_y - my_y);
-
-    	bool x_dirn = (dest_x >= my_x);
-    	bool y_dirn = (dest_y >= my_y);
-
-    	// already checked that in outportCompute() function
-    	assert(!(x_hops == 0 && y_hops == 0));
-
-    	if (x_hops > 0) {
-    	    if (x_dirn) {
-    	        assert(inport_dirn == "Local" || inport_dirn == "West");
-    	        outport_dirn = "East";
-    	    } else {
-    	        assert(inport_dirn == "Local" || inport_dirn == "East");
-    	        outport_dirn = "West";
-    	    }
-    	} else if (y_hops > 0) {
-    	    if (y_dirn) {
-    	        // "Local" or "South" or "West" or "East"
-    	        assert(inport_dirn != "North");
-    	        outport_dirn = "North";
-    	    } else {
-    	        // "Local" or "North" or "West" or "East"
-    	        assert(inport_dirn != "South");
-    	        outport_dirn = "South";
-    	    }
-    	} else {
-    	    // x_hops == 0 and y_hops == 0
-    	    // this is not possible
-    	    // already checked that in outportCompute() function
-    	    panic("x_hops == y_hops == 0");
-    	}
-
-	} else if ((dest_id < 32) && (src_id <32) && (my_id <32) && (dest_id > 15) && (src_id >15) && (my_id >15)) { /* chiplet 2 x-y routing */
-		//my_id = my_id - 16;
-    	//dest_id = dest_id - 16;
-		//src_id = src_id - 16;
-
-		int my_x = my_id % num_cols;
-   		int my_y = my_id / num_cols;
-
-	    int dest_x = dest_id % num_cols;
-    	int dest_y = dest_id / num_cols;
-
-    	int x_hops = abs(dest_x - my_x);
-    	int y_hops = abs(dest_y - my_y);
-
-    	bool x_dirn = (dest_x >= my_x);
-    	bool y_dirn = (dest_y >= my_y);
-
-    	// already checked that in outportCompute() function
-    	assert(!(x_hops == 0 && y_hops == 0));
-
-    	if (x_hops > 0) {
-    	    if (x_dirn) {
-    	        assert(inport_dirn == "Local" || inport_dirn == "West");
-    	        outport_dirn = "East";
-    	    } else {
-    	        assert(inport_dirn == "Local" || inport_dirn == "East");
-    	        outport_dirn = "West";
-    	    }
-    	} else if (y_hops > 0) {
-    	    if (y_dirn) {
-    	        // "Local" or "South" or "West" or "East"
-    	        assert(inport_dirn != "North");
-    	        outport_dirn = "North";
-    	    } else {
-    	        // "Local" or "North" or "West" or "East"
-    	        assert(inport_dirn != "South");
-    	        outport_dirn = "South";
-    	    }
-    	} else {
-    	    // x_hops == 0 and y_hops == 0
-    	    // this is not possible
-    	    // already checked that in outportCompute() function
-    	    panic("x_hops == y_hops == 0");
-    	}
-
-	} else if ((dest_id < 48) && (src_id <48) && (my_id <48) && (dest_id > 31) && (src_id >31) && (my_id >31)) { /* chiplet 3 x-y routing */
-		//my_id = my_id - 32;
-    	//dest_id = dest_id - 32;
-		//src_id = src_id - 32;
-
-		int my_x = my_id % num_cols;
-   		int my_y = my_id / num_cols;
-
-	    int dest_x = dest_id % num_cols;
-    	int dest_y = dest_id / num_cols;
-
-    	int x_hops = abs(dest_x - my_x);
-    	int y_hops = abs(dest_y - my_y);
-
-    	bool x_dirn = (dest_x >= my_x);
-    	bool y_dirn = (dest_y >= my_y);
-
-    	// already checked that in outportCompute() function
-    	assert(!(x_hops == 0 && y_hops == 0));
-
-    	if (x_hops > 0) {
-    	    if (x_dirn) {
-    	        assert(inport_dirn == "Local" || inport_dirn == "West");
-    	        outport_dirn = "East";
-    	    } else {
-    	        assert(inport_dirn == "Local" || inport_dirn == "East");
-    	        outport_dirn = "West";
-    	    }
-    	} else if (y_hops > 0) {
-    	    if (y_dirn) {
-    	        // "Local" or "South" or "West" or "East"
-    	        assert(inport_dirn != "North");
-    	        outport_dirn = "North";
-    	    } else {
-    	        // "Local" or "North" or "West" or "East"
-    	        assert(inport_dirn != "South");
-    	        outport_dirn = "South";
-    	    }
-    	} else {
-    	    // x_hops == 0 and y_hops == 0
-    	    // this is not possible
-    	    // already checked that in outportCompute() function
-    	    panic("x_hops == y_hops == 0");
-    	}
-
-	} else if ((dest_id < 64) && (src_id <64) && (my_id <64) && (dest_id > 47) && (src_id >47) && (my_id >47)) { /* Interposer x-y routing */
-		//my_id = my_id - 48;
-    	//dest_id = dest_id - 48;
-		//src_id = src_id - 48;
-	
-		if (use_random_adaptive) {
-				int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-				
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-
-				if (x_hops == 0)
-   				{
-   			    	 if (y_dirn > 0)
-   			        	 outport_dirn = "North";
-   			     	else
-   			        	 outport_dirn = "South";
-   				}
-   			 	else if (y_hops == 0)
-   			 	{
-   			 	    if (x_dirn > 0)
-   			       	  outport_dirn = "East";
-   			    	else
-   			         outport_dirn = "West";
-   			 	} else {
-   			     	int rand = random() % 2;
-					
-					bool freeVC_N =0;	
-					bool freeVC_E =0;
-					bool freeVC_S =0;
-					bool freeVC_W =0;
-		
-					m_input_unit = m_router->get_inputUnit_ref();
-    				m_output_unit = m_router->get_outputUnit_ref();
-					
-					freeVC_N = 	m_output_unit[m_outports_dirn2idx["North"]]->has_free_vc(route.vnet);
-					freeVC_E = 	m_output_unit[m_outports_dirn2idx["East"]]->has_free_vc(route.vnet);
-					freeVC_S = 	m_output_unit[m_outports_dirn2idx["South"]]->has_free_vc(route.vnet);
-					freeVC_W = 	m_output_unit[m_outports_dirn2idx["West"]]->has_free_vc(route.vnet);
-					
-					if (x_dirn && y_dirn) { // Quadrant I
-						if (freeVC_N & freeVC_E) {
-							outport_dirn = rand ? "North" : "East";
-						} else if (freeVC_E) {
-							outport_dirn = "East";
-						} else if (freeVC_N) {
-							outport_dirn = "North";
-						} else {
-							outport_dirn = rand ? "North" : "East";
-						}
-					} else if (!x_dirn && y_dirn) { // Quadrant II
-						if (freeVC_N & freeVC_W) {
-							outport_dirn = rand ? "North" : "West";
-						} else if (freeVC_W) {
-							outport_dirn = "West";
-						} else if (freeVC_N) {
-							outport_dirn = "North";
-						} else {
-							outport_dirn = rand ? "North" : "West";
-						}
-					} else if (!x_dirn && !y_dirn) { // Quadrant III
-    			    	if (freeVC_W & freeVC_S) {
-							outport_dirn = rand ? "West" : "South";
-						} else if (freeVC_S) {
-							outport_dirn = "South";
-						} else if (freeVC_W) {
-							outport_dirn = "West";
-						} else {
-							outport_dirn = rand ? "West" : "South";
-						}
-					
-					} else {// Quadrant IV
-    			    	if (freeVC_E & freeVC_S) {
-							outport_dirn = rand ? "East" : "South";
-						} else if (freeVC_S) {
-							outport_dirn = "South";
-						} else if (freeVC_E) {
-							outport_dirn = "East";
-						} else {
-							outport_dirn = rand ? "East" : "South";
-						}
-					}
-			}
-			
-		} else if (use_random_oblivious) {
-				int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-				
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-
-				if (x_hops == 0)
-   				{
-   			    	 if (y_dirn > 0)
-   			        	 outport_dirn = "North";
-   			     	else
-   			        	 outport_dirn = "South";
-   				}
-   			 	else if (y_hops == 0)
-   			 	{
-   			 	    if (x_dirn > 0)
-   			       	  outport_dirn = "East";
-   			    	else
-   			         outport_dirn = "West";
-   			 	} else {
-   			     	int rand = random() % 2;
-
-   			     	if (x_dirn && y_dirn) // Quadrant I
-   			        	 outport_dirn = rand ? "East" : "North";
-   			     	else if (!x_dirn && y_dirn) // Quadrant II
-   			        	 outport_dirn = rand ? "West" : "North";
-   			     	else if (!x_dirn && !y_dirn) // Quadrant III
-   			        	 outport_dirn = rand ? "West" : "South";
-   			     	else // Quadrant IV
-   			        	 outport_dirn = rand ? "East" : "South";
-   			 	}
-		} else {
-
-				int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-
-    			int x_hops = abs(dest_x - my_x);
-    			int y_hops = abs(dest_y - my_y);
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-
-    			if (x_hops > 0) {
-    			    if (x_dirn) {
-    			        assert(inport_dirn == "Local" || inport_dirn == "West");
-    			        outport_dirn = "East";
-    			    } else {
-    			        assert(inport_dirn == "Local" || inport_dirn == "East");
-    			        outport_dirn = "West";
-    			    }
-    			} else if (y_hops > 0) {
-    			    if (y_dirn) {
-    			        // "Local" or "South" or "West" or "East"
-    			        assert(inport_dirn != "North");
-    			        outport_dirn = "North";
-    			    } else {
-    			        // "Local" or "North" or "West" or "East"
-    			        assert(inport_dirn != "South");
-    			        outport_dirn = "South";
-    			    }
-    			} else {
-    			    // x_hops == 0 and y_hops == 0
-    			    // this is not possible
-    			    // already checked that in outportCompute() function
-    			    panic("x_hops == y_hops == 0");
-    			}
-		}
-
-
-	} else { /* inter sub-mesh routing */
-		  if ((src_id <16) && (my_id <16)) { /*chiplet1 to interposer*/
-			  //inport_dirn = "Local";
-			  //int src_id_G  = src_id ;
-			  //int my_id_G   = my_id  ;
-			  //int dest_id_G = dest_id;
-			  
-			  //std::cout<<""<<std::endl;
-//std::cout<<src_id<<","<<dest_id<<std::endl;
-			  //std::cout<<"inter-mesh movement - chiplet1 to interposer"<<std::endl;
-			  //std::cout<<"my_id_G: "<<my_id_G<<std::endl;
-			  //std::cout<<"dest_id_G: "<<dest_id_G<<std::endl;
-		   	  //std::cout<<"src_id_G: "<<src_id_G<<std::endl;
-			  
-			  
-			  switch (id_for_route%4) {
-			  		case 0: dest_id = 0;
-							break;
-					case 1: dest_id = 1;
-							break;
-					case 2: dest_id = 2;
-							break;
-					case 3: dest_id = 3;
-							break;
-				}
-				
-		  		int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id ==dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-				
-				if (my_id ==dest_id) {
-						outport_dirn = "South";
-		  		} else if (x_hops > 0) {
-    			    if (x_dirn) {
-    			        assert(inport_dirn == "Local" || inport_dirn == "West");
-    			        outport_dirn = "East";
-    			    } else {
-    			        assert(inport_dirn == "Local" || inport_dirn == "East");
-    			        outport_dirn = "West";
-    			    }
-    			} else if (y_hops > 0) {
-    			    if (y_dirn) {
-    			        // "Local" or "South" or "West" or "East"
-    			        assert(inport_dirn != "North");
-    			        outport_dirn = "North";
-    			    } else {
-    			        // "Local" or "North" or "West" or "East"
-    			        assert(inport_dirn != "South");
-    			        outport_dirn = "South";
-    			    }  
-    			} else {
-    			    // x_hops == 0 and y_hops == 0
-    			    // this is not possible
-    			    // already checked that in outportCompute() function
-    			    panic("x_hops == y_hops == 0");
-    			}
-
-				//std::cout<<"outport_dirn: "<<outport_dirn<<std::endl;
-
-		
-		  } else if ((src_id <32) && (my_id <32) && (src_id >15) && (my_id >15) ) { /* chiplet2 to interposer*/
-			    //inport_dirn = "Local";
-			  	//int src_id_G  = src_id ;
-			  	//int my_id_G   = my_id  ;
-			  	//int dest_id_G = dest_id;
-			    //std::cout<<""<<std::endl;
-				//std::cout<<src_id<<","<<dest_id<<std::endl;
-			  	//std::cout<<"inter-mesh movement - chiplet2 to interposer"<<std::endl;
-			  	//std::cout<<"my_id_G: "<<my_id_G<<std::endl;
-			 	//std::cout<<"dest_id_G: "<<dest_id_G<<std::endl;
-		   	 	//std::cout<<"src_id_G: "<<src_id_G<<std::endl;
-			  
-			  	switch (id_for_route%4) {
-			  		case 0: dest_id = 16;
-							break;
-					case 1: dest_id = 17;
-							break;
-					case 2: dest_id = 18;
-							break;
-					case 3: dest_id = 19;
-							break;
-				}
-				
-				//my_id = my_id - 16;
-    			//dest_id = dest_id - 16;
-				//src_id = src_id - 16;
-
-		  		int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-				
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-				
-				if (my_id == dest_id) {
-						outport_dirn = "South";
-		  		} else if (x_hops > 0) {
-    			    if (x_dirn) {
-    			        assert(inport_dirn == "Local" || inport_dirn == "West");
-    			        outport_dirn = "East";
-    			    } else {
-    			        assert(inport_dirn == "Local" || inport_dirn == "East");
-    			        outport_dirn = "West";
-    			    }
-    			} else if (y_hops > 0) {
-    			    if (y_dirn) {
-    			        // "Local" or "South" or "West" or "East"
-    			        assert(inport_dirn != "North");
-    			        outport_dirn = "North";
-    			    } else {
-    			        // "Local" or "North" or "West" or "East"
-    			        assert(inport_dirn != "South");
-    			        outport_dirn = "South";
-    			    }  
-    			} else {
-    			    // x_hops == 0 and y_hops == 0
-    			    // this is not possible
-    			    // already checked that in outportCompute() function
-    			    panic("x_hops == y_hops == 0");
-    			}
-
-				//std::cout<<"outport_dirn: "<<outport_dirn<<std::endl;
-		
-		  } else if ((src_id < 48) && (my_id <48) && (src_id >31) && (my_id >31) ) { /* chiplet3 to interposer*/
-			    //inport_dirn = "Local";
-			  	//int src_id_G  = src_id ;
-			  	//int my_id_G   = my_id  ;
-			  	//int dest_id_G = dest_id;
-			    //std::cout<<""<<std::endl;
-				//std::cout<<src_id<<","<<dest_id<<std::endl;
-			  	//std::cout<<"inter-mesh movement - chiplet3 to interposer"<<std::endl;
-			  	//std::cout<<"my_id_G: "<<my_id_G<<std::endl;
-			  	//std::cout<<"dest_id_G: "<<dest_id_G<<std::endl;
-		   	  	//std::cout<<"src_id_G: "<<src_id_G<<std::endl;
-			  	
-				switch (id_for_route%4) {
-			  		case 0: dest_id = 44;
-							break;
-					case 1: dest_id = 45;
-							break;
-					case 2: dest_id = 46;
-							break;
-					case 3: dest_id = 47;
-							break;
-				}
-				
-				//my_id = my_id - 32;
-    			//dest_id = dest_id - 32;
-				//src_id = src_id - 32;
-
-		  		int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-				
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-				
-				if (my_id ==dest_id) {
-						outport_dirn = "North";
-		  		} else if (x_hops > 0) {
-    			    if (x_dirn) {
-    			        assert(inport_dirn == "Local" || inport_dirn == "West");
-    			        outport_dirn = "East";
-    			    } else {
-    			        assert(inport_dirn == "Local" || inport_dirn == "East");
-    			        outport_dirn = "West";
-    			    }
-    			} else if (y_hops > 0) {
-    			    if (y_dirn) {
-    			        // "Local" or "South" or "West" or "East"
-    			        assert(inport_dirn != "North");
-    			        outport_dirn = "North";
-    			    } else {
-    			        // "Local" or "North" or "West" or "East"
-    			        assert(inport_dirn != "South");
-    			        outport_dirn = "South";
-    			    }  
-    			} else {
-    			    // x_hops == 0 and y_hops == 0
-    			    // this is not possible
-    			    // already checked that in outportCompute() function
-    			    panic("x_hops == y_hops == 0");
-    			}
-				//std::cout<<"outport_dirn: "<<outport_dirn<<std::endl;
-		
-		  } else if (my_id > 47) { /* interposer routing */
-			    //int src_id_G  = src_id ;
-			  	//int my_id_G   = my_id  ;
-			  	int dest_id_G = dest_id;
-				inport_dirn = "Local";
-			    //std::cout<<""<<std::endl;
-				//std::cout<<src_id<<","<<dest_id<<std::endl;
-			  	//std::cout<<"inter-mesh movement - interposer routing"<<std::endl;
-			  	//std::cout<<"my_id_G: "<<my_id_G<<std::endl;
-			 	//std::cout<<"dest_id_G: "<<dest_id_G<<std::endl;
-		   	  	//std::cout<<"src_id_G: "<<src_id_G<<std::endl;	
-			
-				if (!interposer_deflect) {
-				
-				if (dest_id < 16) {
-					switch (dest_id%4) {
-			  		case 3: dest_id = 60;
-							break;
-					case 2: dest_id = 56;
-							break;
-					case 1: dest_id = 52;
-							break;
-					case 0: dest_id = 48;
-							break;
-					}
-				} else if ((dest_id > 15) && (dest_id < 32)) {
-					switch (dest_id%4) {
-			  		case 0: dest_id = 63;
-							break;
-					case 1: dest_id = 59;
-							break;
-					case 2: dest_id = 55;
-							break;
-					case 3: dest_id = 51;
-							break;
-					}
-				} else if ((dest_id > 31) && (dest_id < 48)) {
-					switch (dest_id%4) {
-			  		case 0: dest_id = 48;
-							break;
-					case 1: dest_id = 49;
-							break;
-					case 2: dest_id = 50;
-							break;
-					case 3: dest_id = 51;
-							break;
-					}
-				} else if (dest_id > 47) {
-					dest_id = dest_id;
-				}
-			   
-				}else {
-				
-				
-				if (dest_id < 16) {
-					switch (dest_id%4) {
-			  		case 3: dest_id = 52;
-							break;
-					case 2: dest_id = 48;
-							break;
-					case 1: dest_id = 60;
-							break;
-					case 0: dest_id = 56;
-							break;
-					}
-				} else if ((dest_id > 15) && (dest_id < 32)) {
-					switch (dest_id%4) {
-			  		case 0: dest_id = 55;
-							break;
-					case 1: dest_id = 51;
-							break;
-					case 2: dest_id = 63;
-							break;
-					case 3: dest_id = 59;
-							break;
-					}
-				} else if ((dest_id > 31) && (dest_id < 48)) {
-					switch (dest_id%4) {
-			  		case 0: dest_id = 50;
-							break;
-					case 1: dest_id = 51;
-							break;
-					case 2: dest_id = 48;
-							break;
-					case 3: dest_id = 49;
-							break;
-					}
-				} else if (dest_id > 47) {
-					dest_id = dest_id;
-				}
-				}
-					
-			   if (use_random_adaptive) {
-				int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-				
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-
-				if (x_hops == 0)
-   				{
-   			    	 if (y_dirn > 0)
-   			        	 outport_dirn = "North";
-   			     	else
-   			        	 outport_dirn = "South";
-   				}
-   			 	else if (y_hops == 0)
-   			 	{
-   			 	    if (x_dirn > 0)
-   			       	  outport_dirn = "East";
-   			    	else
-   			         outport_dirn = "West";
-   			 	} else {
-   			     	int rand = random() % 2;
-					
-					bool freeVC_N =0;	
-					bool freeVC_E =0;
-					bool freeVC_S =0;
-					bool freeVC_W =0;
-		
-					m_input_unit = m_router->get_inputUnit_ref();
-    				m_output_unit = m_router->get_outputUnit_ref();
-					
-					freeVC_N = 	m_output_unit[m_outports_dirn2idx["North"]]->has_free_vc(route.vnet);
-					freeVC_E = 	m_output_unit[m_outports_dirn2idx["East"]]->has_free_vc(route.vnet);
-					freeVC_S = 	m_output_unit[m_outports_dirn2idx["South"]]->has_free_vc(route.vnet);
-					freeVC_W = 	m_output_unit[m_outports_dirn2idx["West"]]->has_free_vc(route.vnet);
-					
-					if (x_dirn && y_dirn) { // Quadrant I
-						if (freeVC_N & freeVC_E) {
-							outport_dirn = rand ? "North" : "East";
-						} else if (freeVC_E) {
-							outport_dirn = "East";
-						} else if (freeVC_N) {
-							outport_dirn = "North";
-						} else {
-							outport_dirn = rand ? "North" : "East";
-						}
-					} else if (!x_dirn && y_dirn) { // Quadrant II
-						if (freeVC_N & freeVC_W) {
-							outport_dirn = rand ? "North" : "West";
-						} else if (freeVC_W) {
-							outport_dirn = "West";
-						} else if (freeVC_N) {
-							outport_dirn = "North";
-						} else {
-							outport_dirn = rand ? "North" : "West";
-						}
-					} else if (!x_dirn && !y_dirn) { // Quadrant III
-    			    	if (freeVC_W & freeVC_S) {
-							outport_dirn = rand ? "West" : "South";
-						} else if (freeVC_S) {
-							outport_dirn = "South";
-						} else if (freeVC_W) {
-							outport_dirn = "West";
-						} else {
-							outport_dirn = rand ? "West" : "South";
-						}
-					
-					} else {// Quadrant IV
-    			    	if (freeVC_E & freeVC_S) {
-							outport_dirn = rand ? "East" : "South";
-						} else if (freeVC_S) {
-							outport_dirn = "South";
-						} else if (freeVC_E) {
-							outport_dirn = "East";
-						} else {
-							outport_dirn = rand ? "East" : "South";
-						}
-					}
-			}
-			
-		} else if (use_random_oblivious) {	
-				int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-				
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-
-				if (my_id == dest_id) {
-							if (dest_id_G < 16) {
-								//std::cout<<"packet wants to enter chiplet1"<<std::endl;
-								outport_dirn = "West";
-				  			} else if (dest_id_G > 15 && dest_id_G < 32) {
-								//std::cout<<"packet wants to enter chiplet2"<<std::endl;
-								outport_dirn = "East";
-							} else if (dest_id_G > 31 && dest_id_G < 48) {
-								//std::cout<<"packet wants to enter chiplet3"<<std::endl;
-								outport_dirn = "South";
-							}	
-				}
-				else if (x_hops == 0)
-   				{
-   			    	 if (y_dirn > 0)
-   			        	 outport_dirn = "North";
-   			     	else
-   			        	 outport_dirn = "South";
-   				}
-   			 	else if (y_hops == 0)
-   			 	{
-   			 	    if (x_dirn > 0)
-   			       	  outport_dirn = "East";
-   			    	else
-   			         outport_dirn = "West";
-   			 	} else {
-   			     	int rand = random() % 2;
-
-   			     	if (x_dirn && y_dirn) // Quadrant I
-   			        	 outport_dirn = rand ? "East" : "North";
-   			     	else if (!x_dirn && y_dirn) // Quadrant II
-   			        	 outport_dirn = rand ? "West" : "North";
-   			     	else if (!x_dirn && !y_dirn) // Quadrant III
-   			        	 outport_dirn = rand ? "West" : "South";
-   			     	else // Quadrant IV
-   			        	 outport_dirn = rand ? "East" : "South";
-   			 	}
-			   } else {
-				//my_id = my_id - 48;
-    			//dest_id = dest_id - 48;
-				//src_id = src_id - 48;
-				
-		  		int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-				
-				int x_hops =1;
-				int y_hops =1;
-    			if (!(my_id == dest_id)) {
-					x_hops = abs(dest_x - my_x);
-    				y_hops = abs(dest_y - my_y);
-				} else {
-					x_hops = 1;
-					y_hops = 1;
-				}
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-				if (my_id == dest_id) {
-					if (dest_id_G < 16) {
-						//std::cout<<"packet wants to enter chiplet1"<<std::endl;
-						outport_dirn = "West";
-		  			} else if (dest_id_G > 15 && dest_id_G < 32) {
-						//std::cout<<"packet wants to enter chiplet2"<<std::endl;
-						outport_dirn = "East";
-					} else if (dest_id_G > 31 && dest_id_G < 48) {
-						//std::cout<<"packet wants to enter chiplet3"<<std::endl;
-						outport_dirn = "South";
-					}	
-				} else if (x_hops > 0) {
-    			    if (x_dirn) {
-						assert(inport_dirn == "Local" || inport_dirn == "West");
-    			        outport_dirn = "East";
-    			    } else {
-						assert(inport_dirn == "Local" || inport_dirn == "East");
-    			        outport_dirn = "West";
-    			    }
-    			} else if (y_hops > 0) {
-    			    if (y_dirn) {
-    			        // "Local" or "South" or "West" or "East"
-    			        assert(inport_dirn != "North");
-    			        outport_dirn = "North";
-    			    } else {
-    			        // "Local" or "North" or "West" or "East"
-    			        assert(inport_dirn != "South");
-    			        outport_dirn = "South";
-    			    }  
-    			} else {
-    			    // x_hops == 0 and y_hops == 0
-    			    // this is not possible
-    			    // already checked that in outportCompute() function
-    			    panic("x_hops == y_hops == 0");
-    			}
-			   }
-				//std::cout<<"outport_dirn: "<<outport_dirn<<std::endl;	
-		  } else { /*interposer to destination chiplets*/
-		  		inport_dirn = "Local";
-		  		//int src_id_G  = src_id ;
-			  	//int my_id_G   = my_id  ;
-			  	//int dest_id_G = dest_id;
-			    //std::cout<<""<<std::endl;
-				//std::cout<<src_id<<","<<dest_id<<std::endl;
-			  	//std::cout<<"inter-mesh movement - dest chiplet"<<std::endl;
-			  	//std::cout<<"my_id_G: "<<my_id_G<<std::endl;
-			 	//std::cout<<"dest_id_G: "<<dest_id_G<<std::endl;
-		   	  	//std::cout<<"src_id_G: "<<src_id_G<<std::endl;	  
- 
-			  	/*if ((dest_id < 16) && (my_id < 16)) {
-					my_id = my_id - 0;
-    				dest_id = dest_id - 0;
-					src_id = src_id - 0;
-				} else if ((dest_id < 32) && (my_id < 32) && (dest_id >15) && (my_id >15)) {
-					my_id = my_id - 16;
-    				dest_id = dest_id - 16;
-					src_id = src_id - 16;
-				} else if ((dest_id < 48) && (my_id < 48) && (dest_id >31) && (my_id >31)) {
-					my_id = my_id - 32;
-    				dest_id = dest_id - 32;
-					src_id = src_id - 32;
-				} else if ((dest_id > 47) && (my_id < 47)) {
-					my_id = my_id - 48;
-    				dest_id = dest_id - 48;
-					src_id = src_id - 48;
-				}*/
-				
-				int my_x = my_id % num_cols;
-   				int my_y = my_id / num_cols;
-
-			    int dest_x = dest_id % num_cols;
-    			int dest_y = dest_id / num_cols;
-
-    			int x_hops = abs(dest_x - my_x);
-    			int y_hops = abs(dest_y - my_y);
-
-    			bool x_dirn = (dest_x >= my_x);
-    			bool y_dirn = (dest_y >= my_y);
-				
-				//std::cout<<"inport_dirn: "<<inport_dirn<<std::endl;
-				//std::cout<<"my_id: "<<my_id<<std::endl;
-				//std::cout<<"dest_id: "<<dest_id<<std::endl;
-				//std::cout<<"src_id: "<<src_id<<std::endl;
-
-    			// already checked that in outportCompute() function
-    			assert(!(x_hops == 0 && y_hops == 0));
-
-    			if (x_hops > 0) {
-    			    if (x_dirn) {
-						
-    			        assert(inport_dirn == "Local" || inport_dirn == "West");
-    			        outport_dirn = "East";
-    			    } else {
-						
-    			        assert(inport_dirn == "Local" || inport_dirn == "East");
-    			        outport_dirn = "West";
-    			    }
-    			} else if (y_hops > 0) {
-    			    if (y_dirn) {
-    			        // "Local" or "South" or "West" or "East"
-    			        assert(inport_dirn != "North");
-    			        outport_dirn = "North";
-    			    } else {
-    			        // "Local" or "North" or "West" or "East"
-    			        assert(inport_dirn != "South");
-    			        outport_dirn = "South";
-    			    }
-    			} else {
-    			    // x_hops == 0 and y_hops == 0
-    			    // this is not possible
-    			    // already checked that in outportCompute() function
-    			    panic("x_hops == y_hops == 0");
-    			}
-				//std::cout<<"outport_dirn: "<<outport_dirn<<std::endl;
-
-
-		  }
-
-	}
-
-    
-    return m_outports_dirn2idx[outport_dirn];
+// Load of a boundary link, higher is less loaded: the down link of the
+// chiplet router on egress, the up link of the interposer router on
+// ingress.
+int
+RoutingUnit::boundaryScore(int region, int idx, int vnet, bool egress)
+{
+    const ChipletLayout::Boundary &b = m_layout->boundary(region, idx);
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
+
+    if (egress)
+        return net_ptr->getRouter(b.router)->get_routingUnit_ref()->
+            outportScore(b.down, vnet, true);
+    return net_ptr->getRouter(b.interposer_router)->get_routingUnit_ref()->
+        outportScore(b.up, vnet, true);
+}
 
+int
+RoutingUnit::pickBoundary(int region, int hash_idx, int vnet, bool egress)
+{
+    int num_boundaries = m_layout->numBoundaries(region);
+    BoundarySelection selection =
+        m_router->get_net_ptr()->getBoundarySelection();
+
+    if (selection == STATIC_HASH_BOUNDARY_ || num_boundaries == 1)
+        return hash_idx;
+
+    if (selection == POWER_OF_TWO_BOUNDARY_) {
+        int a = m_rng.random<int>(0, num_boundaries - 1);
+        int b = m_rng.random<int>(0, num_boundaries - 2);
+        if (b >= a)
+            b++;
+        return (boundaryScore(region, b, vnet, egress) >
+                boundaryScore(region, a, vnet, egress)) ? b : a;
+    }
 
+    // least loaded; ties go to the first one from the hashed boundary on
+    assert(selection == LEAST_LOADED_BOUNDARY_);
+    int best = hash_idx;
+    int best_score = boundaryScore(region, hash_idx, vnet, egress);
+    for (int i = 1; i < num_boundaries; i++) {
+        int idx = (hash_idx + i) % num_boundaries;
+        int score = boundaryScore(region, idx, vnet, egress);
+        if (score > best_score) {
+            best = idx;
+            best_score = score;
+        }
+    }
+    return best;
 }
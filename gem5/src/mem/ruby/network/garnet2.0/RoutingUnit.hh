@@ -34,6 +34,9 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 
+#include <vector>
+
+#include "base/random.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -44,71 +47,225 @@ class InputUnit;
 class Router;
 class OutputUnit;
 
+// How a leg within one region (the interposer, or a chiplet) picks its
+// direction
+enum InterposerRouting { INTERPOSER_XY_, INTERPOSER_RANDOM_OBLIVIOUS_,
+                         INTERPOSER_RANDOM_ADAPTIVE_ };
+
+// Knobs of the chiplet (CUSTOM_) routing that differ between
+// RoutingVariants
+struct RoutingVariantConfig
+{
+    // pick the source chiplet boundary router by src (else by dest) id
+    bool boundary_by_src;
+    // use the deflected interposer boundary map
+    bool interposer_deflect;
+    // routing between two interposer routers
+    InterposerRouting intra_interposer;
+    // routing across the interposer between two chiplets
+    InterposerRouting transit_interposer;
+    // RANDOM_OBLIVIOUS_ routes VC 0 with the oblivious turn model
+    bool turn_model_vc0;
+    // routing within the source and destination chiplets
+    InterposerRouting intra_chiplet;
+    // keep the first VC of each vnet as an escape VC on the
+    // chipletEscapeDirn paths
+    bool escape_vc;
+};
+
 class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
 
-    int outportCompute(RouteInfo route,
-                      int inport,
-                      PortDirection inport_dirn, int vc);
-    
+    // Bind the routing policy selected in GarnetNetwork.py.
+    // Called from Router::init(), once the network is set.
+    void init();
+
+    inline int
+    outportCompute(const RouteInfo &route, int inport,
+                   PortDirn inport_dirn, int vc)
+    {
+        return (this->*m_outport_compute)(route, inport, inport_dirn, vc);
+    }
+
 
     // Topology-agnostic Routing Table based routing (default)
     void addRoute(const NetDest& routing_table_entry);
     void addWeight(int link_weight);
 
+    // Flatten the routing table into per-destination candidate lists.
+    // Called once, after Topology::createLinks added every link.
+    void buildDestinationTable(int num_nodes);
+
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(int vnet, int dest_ni);
 
     // Topology-specific direction based routing
-    void addInDirection(PortDirection inport_dirn, int inport);
-    void addOutDirection(PortDirection outport_dirn, int outport);
+    void addInDirection(PortDirn inport_dirn, int inport);
+    void addOutDirection(PortDirn outport_dirn, int outport);
 
     // Routing for Mesh
-    int outportComputeXY(RouteInfo route,
+    int outportComputeXY(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         PortDirn inport_dirn);
 
-    int outportComputeTurnModelOblivious(RouteInfo route,
+    int outportComputeTurnModelOblivious(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         PortDirn inport_dirn);
 
-    int outportComputeTurnModelAdaptive(RouteInfo route,
+    int outportComputeTurnModelAdaptive(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         PortDirn inport_dirn);
 
 
-    int outportComputeRandomOblivious(RouteInfo route,
+    int outportComputeRandomOblivious(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         PortDirn inport_dirn);
 
-    int outportComputeRandomAdaptive(RouteInfo route,
+    int outportComputeRandomAdaptive(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         PortDirn inport_dirn,
+                         int vc);
 
     // Custom Routing Algorithm using Port Directions
-    int outportComputeCustom(RouteInfo route,
+    int outportComputeCustom(const RouteInfo &route,
                              int inport,
-                             PortDirection inport_dirn);
+                             PortDirn inport_dirn,
+                             int vc);
 
     
-    // Inport and Outport direction to idx maps
-    std::map<PortDirection, int> m_inports_dirn2idx;
-    std::map<int, PortDirection> m_inports_idx2dirn;
-    std::map<int, PortDirection> m_outports_idx2dirn;
-    std::map<PortDirection, int> m_outports_dirn2idx;
+    // Direction <-> port idx lookups. A direction with no port on this
+    // router maps to INVALID_PORT_; inportIdx/outportIdx assert on it,
+    // findOutport does not.
+    inline int
+    inportIdx(PortDirn dirn)
+    {
+        assert(dirn >= 0 && dirn < MAX_PORT_DIRN_);
+        assert(m_inports_dirn2idx[dirn] != INVALID_PORT_);
+        return m_inports_dirn2idx[dirn];
+    }
+
+    inline int
+    outportIdx(PortDirn dirn)
+    {
+        assert(dirn >= 0 && dirn < MAX_PORT_DIRN_);
+        assert(m_outports_dirn2idx[dirn] != INVALID_PORT_);
+        return m_outports_dirn2idx[dirn];
+    }
+
+    inline int
+    findOutport(PortDirn dirn)
+    {
+        if (dirn < 0 || dirn >= MAX_PORT_DIRN_)
+            return INVALID_PORT_;
+        return m_outports_dirn2idx[dirn];
+    }
+
+    inline PortDirn
+    inportDirn(int inport)
+    {
+        assert(inport >= 0 && inport < m_inports_idx2dirn.size());
+        return m_inports_idx2dirn[inport];
+    }
+
+    inline PortDirn
+    outportDirn(int outport)
+    {
+        assert(outport >= 0 && outport < m_outports_idx2dirn.size());
+        return m_outports_idx2dirn[outport];
+    }
+
+    // true if 'dirn' exists on this router and has a free VC in 'vnet'
+    bool outportHasFreeVC(PortDirn dirn, int vnet);
+    // free VCs (FREE_VC_SCORE_ each) plus credits of outport 'dirn'
+    int outportScore(PortDirn dirn, int vnet, bool escape_ok);
+    // congestion sideband: < 0 if the region behind 'a' is less
+    // congested than the one behind 'b'; 0 without the sideband
+    int regionalCompare(PortDirn a, PortDirn b);
+
+    // Chiplet routing: fix the boundaries of a packet injected at this
+    // router, see RouteInfo::egress_boundary
+    void selectBoundaries(RouteInfo &route);
+    // and its interposer intermediate, see RouteInfo::intermediate
+    void selectIntermediate(RouteInfo &route);
+
+    // RANDOM_ADAPTIVE_ keeps the first VC of each vnet as an escape VC;
+    // OutputUnit only allocates it when escapeVCAllowed()
+    inline bool hasEscapeVC() const { return m_escape_vc; }
+    inline uint64_t escapeVC(int vnet) const
+    { return 1ULL << (vnet * m_vc_per_vnet); }
+    bool escapeVCAllowed(const RouteInfo &route, PortDirn outport_dirn);
+    // Outport of the escape path, or -1 at the destination router
+    int escapeOutport(const RouteInfo &route);
+    // A flit of the chiplet routing took the escape VC: aim its
+    // adaptive hops at the escape boundaries too
+    void enterEscape(RouteInfo &route);
 
   private:
+    typedef int (RoutingUnit::*OutportComputeFn)(const RouteInfo &route,
+                                                 int inport,
+                                                 PortDirn inport_dirn,
+                                                 int vc);
+
+    // Instantiated once per policy in RoutingPolicy.hh
+    template <class Policy>
+    int outportComputeWith(const RouteInfo &route, int inport,
+                           PortDirn inport_dirn, int vc);
+
+    // Direction from (my_x, my_y) towards (dest_x, dest_y) in a mesh
+    PortDirn xyDirn(int my_x, int my_y, int dest_x, int dest_y,
+                    PortDirn inport_dirn);
+    PortDirn randomObliviousDirn(int my_x, int my_y, int dest_x, int dest_y);
+    PortDirn randomAdaptiveDirn(int my_x, int my_y, int dest_x, int dest_y,
+                                int vnet);
+    int boundaryScore(int region, int idx, int vnet, bool egress);
+    int pickBoundary(int region, int hash_idx, int vnet, bool egress);
+    int outportComputeTurnModel(const RouteInfo &route,
+                                PortDirn inport_dirn, bool adaptive);
+    // Direction between two routers of one region of the chiplet layout
+    PortDirn regionDirn(InterposerRouting algo, int my_id, int dest_id,
+                        int vnet, PortDirn inport_dirn);
+    PortDirn escapeDirn(const RouteInfo &route);
+    PortDirn chipletEscapeDirn(const RouteInfo &route);
+
     Router *m_router;
 
+    OutportComputeFn m_outport_compute;
+    RoutingVariantConfig m_variant;
+    // set by init() for the CUSTOM_ routing
+    const ChipletLayout *m_layout;
+    // network-wide coordinate table, indexed by router id, and the
+    // entry of this router
+    const RouterCoord *m_coords;
+    RouterCoord m_coord;
+
+    // this router's rows of the TurnModel table, for the turn models
+    const uint8_t *m_turn_row;
+
+    int m_vc_per_vnet;
+    bool m_escape_vc;
+    const CongestionSideband *m_sideband;
+
+    // Inport and Outport direction to idx tables, indexed by PortDirn,
+    // and idx to direction tables, indexed by port idx
+    int m_inports_dirn2idx[MAX_PORT_DIRN_];
+    int m_outports_dirn2idx[MAX_PORT_DIRN_];
+    std::vector<PortDirn> m_inports_idx2dirn;
+    std::vector<PortDirn> m_outports_idx2dirn;
+
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;  
 
-  //added
-	std::vector<InputUnit *> m_input_unit;
-  std::vector<OutputUnit *> m_output_unit;  
+    // Minimum weight outports towards destination node d are
+    // m_dest_outports[m_dest_offset[d] .. m_dest_offset[d + 1])
+    std::vector<int> m_dest_offset;
+    std::vector<int> m_dest_outports;
+    // every random routing choice: equal weight table candidates on
+    // unordered vnets, random directions, intermediates and boundaries.
+    // Seeded with the router id, so routes (and source routes) replay.
+    Random m_rng;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#include "mem/ruby/network/garnet2.0/SwapTurn.hh"
+
+#include "mem/ruby/network/garnet2.0/Router.hh"
+
+SwapTurn::SwapTurn(Router *router, Cycles period)
+    : m_router(router), m_period(period), m_armed(false)
+{
+    assert(m_router->get_id() < m_period);
+}
+
+void
+SwapTurn::arm()
+{
+    if (m_armed)
+        return;
+
+    // cycles from the next one to the router's slot
+    Cycles next = m_router->curCycle() + Cycles(1);
+    uint64_t offset =
+        (m_router->get_id() + m_period - next % m_period) % m_period;
+
+    m_armed = true;
+    m_router->schedule_wakeup(Cycles(1 + offset));
+}
+
+void
+SwapTurn::take()
+{
+    if (!m_armed || m_router->curCycle() % m_period != m_router->get_id())
+        return;
+    m_armed = false;
+
+    // rearmed for the next turn only if there is still something to swap
+    if (m_router->swap_turn())
+        arm();
+}
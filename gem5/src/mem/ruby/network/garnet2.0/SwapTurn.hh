@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_SWAPTURN_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_SWAPTURN_HH__
+
+#include "base/types.hh"
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+
+class Router;
+
+// iSWAP turns of one router: the cycles where
+//     curCycle() % (whenToSwap * num_routers) == router id
+// While the router holds a flit it could swap, a wakeup of the router
+// is scheduled at its next turn; an empty router has none pending.
+// The turn itself runs at the start of Router::wakeup(), before the
+// input units and switch allocation, as the swaps always have: the
+// order does not depend on how events of the same cycle are scheduled.
+class SwapTurn
+{
+  public:
+    SwapTurn(Router *router, Cycles period);
+
+    // schedule the router at the next turn after this cycle, unless
+    // already done
+    void arm();
+    // from Router::wakeup(): run the turn if this cycle is it
+    void take();
+
+  private:
+    Router *m_router;
+    Cycles m_period;
+    bool m_armed;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_SWAPTURN_HH__
@@ -33,11 +33,13 @@
 
 #include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
 
+#include "base/bitfield.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 #include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
 
 SwitchAllocator::SwitchAllocator(Router *router)
     : Consumer(router)
@@ -50,18 +52,36 @@ SwitchAllocator::SwitchAllocator(Router *router)
     m_output_arbiter_activity = 0;
 }
 
+// First set bit of 'mask' at or after 'start', wrapping around, i.e. the
+// winner of a round-robin arbiter whose pointer is at 'start'.
+// 'mask' must be non-zero.
+static inline int
+round_robin_pick(uint64_t mask, int start)
+{
+    uint64_t upper = mask & (~0ULL << start);
+    return findLsbSet(upper ? upper : mask);
+}
+
 void
 SwitchAllocator::init()
 {
     m_input_unit = m_router->get_inputUnit_ref();
     m_output_unit = m_router->get_outputUnit_ref();
+    m_sa_type = m_router->get_net_ptr()->getSwitchAllocator();
 
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
+    m_inport_requests.resize(m_num_outports, 0);
     m_vc_winners.resize(m_num_outports);
+    m_blocked_flit.assign(m_num_inports * m_num_vcs, NULL);
+    m_blocked_since.assign(m_num_inports * m_num_vcs, Cycles(0));
+
+    // the bitmask SA keeps one bit per inport / per VC in a word
+    assert(m_num_inports <= 64);
+    assert(m_num_vcs <= 64);
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i] = 0;
@@ -94,7 +114,9 @@ SwitchAllocator::wakeup()
     arbitrate_inports(); // First stage of allocation
     arbitrate_outports(); // Second stage of allocation
 
-    clear_request_vector();
+    // the bitmask requests are cleared as SA-II consumes them
+    if (m_sa_type != BITMASK_SA_)
+        clear_request_vector();
     check_for_wakeup();
 }
 
@@ -114,57 +136,119 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
-
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
-
-            if (m_input_unit[inport]->need_stage(invc, SA_,
-                m_router->curCycle())) {
-
-                // This flit is in SA stage
-                // because we must be setting it in the inport in InputUnit.hh
-                // stage. func: grant_outport()
-
-                // int  outport = m_input_unit[inport]->get_outport(invc);
-                int  outport =
-                    m_input_unit[inport]->peekTopFlit(invc)->get_outport();
-                // this is done for multi flit packet.. HEAD/HEAD_TAIL
-                // will have outvc = -1
-                // set in vc_allocate
-                int outvc = -1;
-
-                #if (MY_PRINT)
-                    cout << "Inport: " << inport <<" invc: "<< invc <<
-                        " outvc: " << outvc <<" outport: " << outport << endl;
-                #endif
-
-               // int  outport = m_input_unit[inport]->get_outport(invc);
-               // int  outvc   = m_input_unit[inport]->get_outvc(invc);
-
-                // check if the flit in this InputVC is allowed to be sent
-                // send_allowed conditions described in that function.
-                bool make_request =
-                    send_allowed(inport, invc, outport, outvc);
-
-                if (make_request) {
-                    m_input_arbiter_activity++;
-                    m_port_requests[outport][inport] = true;
-                    m_vc_winners[outport][inport]= invc;
-
-                    // Update Round Robin pointer
-                    m_round_robin_invc[inport]++;
-                    if (m_round_robin_invc[inport] >= m_num_vcs)
-                        m_round_robin_invc[inport] = 0;
-
-                    break; // got one vc winner for this port
-                }
-            }
+        // send_allowed may reroute a flit and feeds the blocked records,
+        // so the reference scan goes first, as a dry run: both arbiters
+        // then see the same VCs, and the records are updated once.
+        int loop_invc = -1;
+        if (m_sa_type == CHECK_SA_)
+            loop_invc = select_invc_loop(inport, true);
+
+        int invc;
+        if (m_sa_type == LOOP_SA_)
+            invc = select_invc_loop(inport);
+        else
+            invc = select_invc_bitmask(inport);
+
+        if (m_sa_type == CHECK_SA_) {
+            if (loop_invc != invc)
+                panic("Router %d SA-I mismatch at inport %d: "
+                      "bitmask invc %d, loop invc %d at time: %lld\n",
+                      m_router->get_id(), inport, invc, loop_invc,
+                      m_router->curCycle());
+        }
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+        if (invc == -1)
+            continue;
+
+        // This flit is in SA stage
+        // because we must be setting it in the inport in InputUnit.hh
+        // stage. func: grant_outport()
+        int  outport =
+            m_input_unit[inport]->peekTopFlit(invc)->get_outport();
+
+        m_input_arbiter_activity++;
+        if (m_sa_type != BITMASK_SA_)
+            m_port_requests[outport][inport] = true;
+        if (m_sa_type != LOOP_SA_)
+            m_inport_requests[outport] |= (1ULL << inport);
+        m_vc_winners[outport][inport]= invc;
+
+        // Update Round Robin pointer
+        m_round_robin_invc[inport]++;
+        if (m_round_robin_invc[inport] >= m_num_vcs)
+            m_round_robin_invc[inport] = 0;
+    }
+}
+
+// SA-I arbiter for one inport: walk the VCs from the round robin
+// pointer and return the first one allowed to request its outport,
+// or -1.
+int
+SwitchAllocator::select_invc_loop(int inport, bool dry_run)
+{
+    int invc = m_round_robin_invc[inport];
+
+    for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+
+        if (m_input_unit[inport]->need_stage(invc, SA_,
+            m_router->curCycle())) {
+
+            // int  outport = m_input_unit[inport]->get_outport(invc);
+            int  outport =
+                m_input_unit[inport]->peekTopFlit(invc)->get_outport();
+            // this is done for multi flit packet.. HEAD/HEAD_TAIL
+            // will have outvc = -1
+            // set in vc_allocate
+            int outvc = -1;
+
+            #if (MY_PRINT)
+                cout << "Inport: " << inport <<" invc: "<< invc <<
+                    " outvc: " << outvc <<" outport: " << outport << endl;
+            #endif
+
+            // check if the flit in this InputVC is allowed to be sent
+            // send_allowed conditions described in that function.
+            if (send_allowed(inport, invc, outport, outvc, dry_run))
+                return invc; // got one vc winner for this port
         }
+
+        invc++;
+        if (invc >= m_num_vcs)
+            invc = 0;
     }
+
+    return -1;
+}
+
+// Same arbiter as select_invc_loop, on a mask of the VCs in SA stage:
+// candidates are visited in round robin order with rotate + ctz.
+// Only the occupied VCs of the inport are tested.
+int
+SwitchAllocator::select_invc_bitmask(int inport)
+{
+    Cycles curTime = m_router->curCycle();
+    if (m_input_unit[inport]->get_earliest_ready() > curTime)
+        return -1;
+
+    uint64_t ready = 0;
+    uint64_t occupied = m_input_unit[inport]->get_occupied_vcs();
+    for (; occupied; occupied &= occupied - 1) {
+        int invc = findLsbSet(occupied);
+        if (m_input_unit[inport]->need_stage(invc, SA_, curTime))
+            ready |= (1ULL << invc);
+    }
+
+    while (ready) {
+        int invc = round_robin_pick(ready, m_round_robin_invc[inport]);
+        int outport = m_input_unit[inport]->peekTopFlit(invc)->get_outport();
+
+        if (send_allowed(inport, invc, outport, -1))
+            return invc;
+
+        ready &= ~(1ULL << invc);
+    }
+
+    return -1;
 }
 
 /*
@@ -188,135 +272,182 @@ SwitchAllocator::arbitrate_outports()
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
     for (int outport = 0; outport < m_num_outports; outport++) {
-        int inport = m_round_robin_inport[outport];
-
-        for (int inport_iter = 0; inport_iter < m_num_inports;
-                 inport_iter++) {
-
-            // inport has a request this cycle for outport
-            if (m_port_requests[outport][inport]) {
-
-                // grant this outport to this inport
-                int invc = m_vc_winners[outport][inport];
-
-                int outvc = m_input_unit[inport]->get_outvc(invc);
-                assert(outvc == -1);
-                if (outvc == -1) {
-                    // VC Allocation - select any free VC from outport
-                    outvc = vc_allocate(outport, inport, invc);
-                }
-
-                if (this->m_router->get_net_ptr()->isEnableInterswap()) {
-                    if (m_input_unit[inport]->peekTopFlit(invc)\
-                                            ->get_RoutedSwap() == true) {
-                        // this means the Routed Swap flit is leaving the router
-                        if(m_router->get_net_ptr()->m_no_is_swap == 0) {
-                            assert(m_router->is_swap == true);
-                        }
-                        #if (MY_PRINT)
-                            cout << "Routed flit has made forward progress "\
-                                    "via switchAllocator clearing both "\
-                                    "'is_swap' bit of router as well as "\
-                                    "'routedSwap' of flit" << endl;
-                        #endif
-                        // clear both bits
-                        // because flit is makig forward progress
-                        // using switch (normal behavior)
-                        m_input_unit[inport]->peekTopFlit(invc)\
-                                            ->unset_RoutedSwap();
-                        m_router->is_swap = false;
-                        // 'send_routedSwap' flag cannot be high here...
-                        // it's been taken care of in Router::wakeup()
-                        assert(m_router->get_send_routedSwap() == false);
-                    }
-                }
-
-                // remove flit from Input VC
-                flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
-
-                if (m_router->get_net_ptr()->isEnableInterswap()) {
-                    // if the same  flit which is pointed by `swap_ptr` leaves
-                    // via switch allocation... movSwapPtr() is all empty then
-                    // API will automatically turn the `swap_ptr` off
-                    if ((inport == m_router->swap_ptr.inport) &&
-                        (invc == m_router->swap_ptr.vcid)) {
-                        m_router->movSwapPtr();
-                    }
-                }
-
-                DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
-                                     "granted outvc %d at outport %d "
-                                     "to invc %d at inport %d to flit %s at "
-                                     "time: %lld\n",
-                        m_router->get_id(), outvc,
-                        m_router->getPortDirectionName(
-                            m_output_unit[outport]->get_direction()),
-                        invc,
-                        m_router->getPortDirectionName(
-                            m_input_unit[inport]->get_direction()),
-                            *t_flit,
-                        m_router->curCycle());
-
-
-                // Update outport field in the flit since this is
-                // used by CrossbarSwitch code to send it out of
-                // correct outport.
-                // Note: post route compute in InputUnit,
-                // outport is updated in VC, but not in flit
-                t_flit->set_outport(outport);
-                PortDirection dirn = m_output_unit[outport]->get_direction();
-                t_flit->set_outport_dir(dirn);
-
-                // set outvc (i.e., invc for next hop) in flit
-                // (This was updated in VC by vc_allocate, but not in flit)
-                t_flit->set_vc(outvc);
-
-                // decrement credit in outvc
-                m_output_unit[outport]->decrement_credit(outvc);
-
-                // flit ready for Switch Traversal
-                t_flit->advance_stage(ST_, m_router->curCycle());
-                m_router->grant_switch(inport, t_flit);
-                m_output_arbiter_activity++;
-
-                if ((t_flit->get_type() == TAIL_) ||
-                    t_flit->get_type() == HEAD_TAIL_) {
-
-                    // This Input VC should now be empty
-                    assert(!(m_input_unit[inport]->isReady(invc,
-                        m_router->curCycle())));
-
-                    // Free this VC
-                    m_input_unit[inport]->set_vc_idle(invc,
-                        m_router->curCycle());
-
-                    // Send a credit back
-                    // along with the information that this VC is now idle
-                    m_input_unit[inport]->increment_credit(invc, true,
-                        m_router->curCycle());
-                } else {
-                    // Send a credit back
-                    // but do not indicate that the VC is idle
-                    m_input_unit[inport]->increment_credit(invc, false,
-                        m_router->curCycle());
-                }
-
-                // remove this request
-                m_port_requests[outport][inport] = false;
-
-                // Update Round Robin pointer
-                m_round_robin_inport[outport]++;
-                if (m_round_robin_inport[outport] >= m_num_inports)
-                    m_round_robin_inport[outport] = 0;
-
-                break; // got a input winner for this outport
+        int inport;
+        if (m_sa_type == LOOP_SA_)
+            inport = select_inport_loop(outport);
+        else
+            inport = select_inport_bitmask(outport);
+
+        if (m_sa_type == CHECK_SA_) {
+            int loop_inport = select_inport_loop(outport);
+            if (loop_inport != inport)
+                panic("Router %d SA-II mismatch at outport %d: "
+                      "bitmask inport %d, loop inport %d at time: %lld\n",
+                      m_router->get_id(), outport, inport, loop_inport,
+                      m_router->curCycle());
+        }
+
+        if (inport == -1)
+            continue;
+
+        grant_inport(outport, inport);
+
+        // Update Round Robin pointer
+        m_round_robin_inport[outport]++;
+        if (m_round_robin_inport[outport] >= m_num_inports)
+            m_round_robin_inport[outport] = 0;
+    }
+}
+
+// SA-II arbiter for one outport: the first inport with a request,
+// starting from the round robin pointer, or -1.
+int
+SwitchAllocator::select_inport_loop(int outport)
+{
+    int inport = m_round_robin_inport[outport];
+
+    for (int inport_iter = 0; inport_iter < m_num_inports;
+             inport_iter++) {
+
+        // inport has a request this cycle for outport
+        if (m_port_requests[outport][inport])
+            return inport;
+
+        inport++;
+        if (inport >= m_num_inports)
+            inport = 0;
+    }
+
+    return -1;
+}
+
+// Same arbiter as select_inport_loop on the request word. Reading the
+// word also clears it, so no per-cycle clear is needed.
+int
+SwitchAllocator::select_inport_bitmask(int outport)
+{
+    uint64_t requests = m_inport_requests[outport];
+    m_inport_requests[outport] = 0;
+
+    if (requests == 0)
+        return -1;
+    return round_robin_pick(requests, m_round_robin_inport[outport]);
+}
+
+// Grant 'outport' to the VC 'inport' won SA-I with: allocate the outvc,
+// read the flit out of the input VC, send it to the crossbar and return
+// a credit upstream.
+void
+SwitchAllocator::grant_inport(int outport, int inport)
+{
+    // grant this outport to this inport
+    int invc = m_vc_winners[outport][inport];
+
+    int outvc = m_input_unit[inport]->get_outvc(invc);
+    assert(outvc == -1);
+    if (outvc == -1) {
+        // VC Allocation - select any free VC from outport
+        outvc = vc_allocate(outport, inport, invc);
+    }
+
+    if (this->m_router->get_net_ptr()->isEnableInterswap()) {
+        if (m_input_unit[inport]->peekTopFlit(invc)\
+                                ->get_RoutedSwap() == true) {
+            // this means the Routed Swap flit is leaving the router
+            if(m_router->get_net_ptr()->m_no_is_swap == 0) {
+                assert(m_router->is_swap == true);
             }
+            #if (MY_PRINT)
+                cout << "Routed flit has made forward progress "\
+                        "via switchAllocator clearing both "\
+                        "'is_swap' bit of router as well as "\
+                        "'routedSwap' of flit" << endl;
+            #endif
+            // clear both bits
+            // because flit is makig forward progress
+            // using switch (normal behavior)
+            m_input_unit[inport]->peekTopFlit(invc)\
+                                ->unset_RoutedSwap();
+            m_router->is_swap = false;
+            // 'send_routedSwap' flag cannot be high here...
+            // it's been taken care of in Router::wakeup()
+            assert(m_router->get_send_routedSwap() == false);
+        }
+    }
 
-            inport++;
-            if (inport >= m_num_inports)
-                inport = 0;
+    // remove flit from Input VC
+    flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
+
+    if (m_router->get_net_ptr()->isEnableInterswap()) {
+        // if the same  flit which is pointed by `swap_ptr` leaves
+        // via switch allocation... movSwapPtr() is all empty then
+        // API will automatically turn the `swap_ptr` off
+        if ((inport == m_router->swap_ptr.inport) &&
+            (invc == m_router->swap_ptr.vcid)) {
+            m_router->movSwapPtr();
         }
     }
+
+    DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
+                         "granted outvc %d at outport %d "
+                         "to invc %d at inport %d to flit %s at "
+                         "time: %lld\n",
+            m_router->get_id(), outvc,
+            m_router->getPortDirectionName(
+                m_output_unit[outport]->get_direction()),
+            invc,
+            m_router->getPortDirectionName(
+                m_input_unit[inport]->get_direction()),
+                *t_flit,
+            m_router->curCycle());
+
+
+    // Update outport field in the flit since this is
+    // used by CrossbarSwitch code to send it out of
+    // correct outport.
+    // Note: post route compute in InputUnit,
+    // outport is updated in VC, but not in flit
+    t_flit->set_outport(outport);
+    PortDirn dirn = m_output_unit[outport]->get_direction();
+    t_flit->set_outport_dir(dirn);
+
+    // set outvc (i.e., invc for next hop) in flit
+    // (This was updated in VC by vc_allocate, but not in flit)
+    t_flit->set_vc(outvc);
+
+    // decrement credit in outvc
+    m_output_unit[outport]->decrement_credit(outvc);
+
+    // flit ready for Switch Traversal
+    t_flit->advance_stage(ST_, m_router->curCycle());
+    m_router->grant_switch(inport, t_flit);
+    m_output_arbiter_activity++;
+
+    if ((t_flit->get_type() == TAIL_) ||
+        t_flit->get_type() == HEAD_TAIL_) {
+
+        // This Input VC should now be empty
+        assert(!(m_input_unit[inport]->isReady(invc,
+            m_router->curCycle())));
+
+        // Free this VC
+        m_input_unit[inport]->set_vc_idle(invc,
+            m_router->curCycle());
+
+        // Send a credit back
+        // along with the information that this VC is now idle
+        m_input_unit[inport]->increment_credit(invc, true,
+            m_router->curCycle());
+    } else {
+        // Send a credit back
+        // but do not indicate that the VC is idle
+        m_input_unit[inport]->increment_credit(invc, false,
+            m_router->curCycle());
+    }
+
+    // remove this request
+    if (m_sa_type != BITMASK_SA_)
+        m_port_requests[outport][inport] = false;
 }
 
 /*
@@ -334,11 +465,12 @@ SwitchAllocator::arbitrate_outports()
  */
 
 bool
-SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
+SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc,
+                              bool dry_run)
 {
-    PortDirection inport_dirn  = m_input_unit[inport]->get_direction();
-    PortDirection outport_dirn = m_output_unit[outport]->get_direction();
-    RouteInfo route = m_input_unit[inport]->peekTopFlit(invc)->get_route();
+    PortDirn inport_dirn  = m_input_unit[inport]->get_direction();
+    PortDirn outport_dirn = m_output_unit[outport]->get_direction();
+    const RouteInfo &route = m_input_unit[inport]->peekTopFlit(invc)->get_route();
 
     // Check if outvc needed
     // Check if credit needed (for multi-flit packet)
@@ -361,11 +493,18 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
             // each VC has at least one buffer,
             // so no need for additional credit check
             has_credit = true;
+        } else if (reroute_to_escape(inport, invc, vnet, outport,
+                                     dry_run)) {
+            has_outvc = true;
+            has_credit = true;
         }
     } else {
         has_credit = m_output_unit[outport]->has_credit(outvc);
     }
 
+    if (!dry_run)
+        update_blocked(inport, invc, !has_outvc);
+
     // cannot send if no outvc or no credit.
     if (!has_outvc || !has_credit)
         return false;
@@ -395,6 +534,82 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
     return true;
 }
 
+void
+SwitchAllocator::update_blocked(int inport, int invc, bool blocked)
+{
+    int idx = inport * m_num_vcs + invc;
+    WaitForGraph *wait_for_graph = m_router->get_net_ptr()->getWaitForGraph();
+    if (!blocked) {
+        if (m_blocked_flit[idx] != NULL && wait_for_graph != NULL)
+            wait_for_graph->unblock(m_router->get_id(), inport, invc);
+        m_blocked_flit[idx] = NULL;
+        return;
+    }
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    if (m_blocked_flit[idx] != t_flit) {
+        m_blocked_flit[idx] = t_flit;
+        m_blocked_since[idx] = m_router->curCycle();
+    }
+    if (wait_for_graph != NULL)
+        wait_for_graph->block(m_router->get_id(), inport, invc,
+                              t_flit->get_outport());
+}
+
+// The record is stale if the flit left the VC (e.g. by a swap) and
+// another one took its place since.
+bool
+SwitchAllocator::is_blocked(int inport, int invc)
+{
+    int idx = inport * m_num_vcs + invc;
+    if (m_blocked_flit[idx] == NULL ||
+        m_input_unit[inport]->vc_isEmpty(invc))
+        return false;
+    return m_input_unit[inport]->peekTopFlit(invc) == m_blocked_flit[idx] &&
+           m_input_unit[inport]->get_enqueue_time(invc) <=
+               m_blocked_since[idx];
+}
+
+Cycles
+SwitchAllocator::get_blocked_cycles(int inport, int invc)
+{
+    if (!is_blocked(inport, invc))
+        return Cycles(0);
+    return m_router->curCycle() - m_blocked_since[inport * m_num_vcs + invc];
+}
+
+// Duato's escape: a head flit with no VC on its adaptive outport may
+// always move to its escape outport instead. Returns true, with the
+// flit and 'outport' updated, if a VC is free there.
+bool
+SwitchAllocator::reroute_to_escape(int inport, int invc, int vnet,
+                                   int &outport, bool dry_run)
+{
+    RoutingUnit *routing_unit = m_router->get_routingUnit_ref();
+    if (!routing_unit->hasEscapeVC())
+        return false;
+
+    flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+    const RouteInfo &route = t_flit->get_route();
+    int escape_outport = routing_unit->escapeOutport(route);
+    if (escape_outport == -1 || escape_outport == outport)
+        return false;
+
+    PortDirn escape_dirn = m_output_unit[escape_outport]->get_direction();
+    if (!m_output_unit[escape_outport]->has_free_vc(vnet, invc,
+            m_input_unit[inport]->get_direction(), escape_dirn, route))
+        return false;
+
+    outport = escape_outport;
+    if (dry_run)
+        return true;
+
+    t_flit->set_outport(escape_outport);
+    t_flit->set_outport_dir(escape_dirn);
+    m_input_unit[inport]->grant_outport(invc, escape_outport);
+    return true;
+}
+
 // Assign a free VC to the winner of the output port.
 int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
@@ -402,9 +617,9 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     // ICN Lab 3:
     // Hint: invc, route, inport_dirn, outport_dirn are provided
     // to implement escape VC
-    PortDirection inport_dirn  = m_input_unit[inport]->get_direction();
-    PortDirection outport_dirn = m_output_unit[outport]->get_direction();
-    RouteInfo route = m_input_unit[inport]->peekTopFlit(invc)->get_route();
+    PortDirn inport_dirn  = m_input_unit[inport]->get_direction();
+    PortDirn outport_dirn = m_output_unit[outport]->get_direction();
+    const RouteInfo &route = m_input_unit[inport]->peekTopFlit(invc)->get_route();
 
     // Select a free VC from the output port
     int vnet = get_vnet(invc);
@@ -414,6 +629,15 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     // has to get a valid VC since it checked before performing SA
     assert(outvc != -1);
 
+    RoutingUnit *routing_unit = m_router->get_routingUnit_ref();
+    if (routing_unit->hasEscapeVC() &&
+        outvc == findLsbSet(routing_unit->escapeVC(vnet))) {
+        flit *t_flit = m_input_unit[inport]->peekTopFlit(invc);
+        RouteInfo escape_route = t_flit->get_route();
+        routing_unit->enterEscape(escape_route);
+        t_flit->set_route(escape_route);
+    }
+
     //TODO: SWAP data base this is commented
     m_input_unit[inport]->grant_outvc(invc, outvc);
     return outvc;
@@ -426,14 +650,34 @@ SwitchAllocator::check_for_wakeup()
 {
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
+    bool wakeup = false;
+    for (int i = 0; i < m_num_inports; i++) {
+        if (m_input_unit[i]->get_earliest_ready() <= nextCycle) {
+            wakeup = true;
+            break;
+        }
+    }
+
+    if (m_sa_type == CHECK_SA_ && wakeup != check_for_wakeup_loop(nextCycle))
+        panic("Router %d VC ready summary out of sync at time: %lld\n",
+              m_router->get_id(), m_router->curCycle());
+
+    if (wakeup)
+        m_router->schedule_wakeup(Cycles(1));
+}
+
+// Reference scan over every inport x VC, used by CHECK_SA_ to validate
+// the per-inport ready summary.
+bool
+SwitchAllocator::check_for_wakeup_loop(Cycles nextCycle)
+{
     for (int i = 0; i < m_num_inports; i++) {
         for (int j = 0; j < m_num_vcs; j++) {
-            if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
-                m_router->schedule_wakeup(Cycles(1));
-                return;
-            }
+            if (m_input_unit[i]->need_stage(j, SA_, nextCycle))
+                return true;
         }
     }
+    return false;
 }
 
 int
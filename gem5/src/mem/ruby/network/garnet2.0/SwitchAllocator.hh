@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_SWITCHALLOCATOR_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_SWITCHALLOCATOR_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -43,6 +44,7 @@
 class Router;
 class InputUnit;
 class OutputUnit;
+class flit;
 
 class SwitchAllocator : public Consumer
 {
@@ -52,13 +54,30 @@ class SwitchAllocator : public Consumer
     void init();
     void clear_request_vector();
     void check_for_wakeup();
+    bool check_for_wakeup_loop(Cycles nextCycle);
     int get_vnet (int invc);
     void print(std::ostream& out) const {};
     void arbitrate_inports();
     void arbitrate_outports();
-    bool send_allowed(int inport, int invc, int outport, int outvc);
+    int select_invc_loop(int inport, bool dry_run = false);
+    int select_invc_bitmask(int inport);
+    int select_inport_loop(int outport);
+    int select_inport_bitmask(int outport);
+    void grant_inport(int outport, int inport);
+    // with 'dry_run', only answer: the flit is not rerouted and the
+    // blocked records are not updated (CHECK_SA_ reference scan)
+    bool send_allowed(int inport, int invc, int outport, int outvc,
+                      bool dry_run = false);
+    bool reroute_to_escape(int inport, int invc, int vnet, int &outport,
+                           bool dry_run = false);
     int vc_allocate(int outport, int inport, int invc);
 
+    // Deadlock symptoms: whether the head flit of (inport, invc) was
+    // last seen in SA without a free VC at its outport, and for how
+    // many cycles it has been so
+    bool is_blocked(int inport, int invc);
+    Cycles get_blocked_cycles(int inport, int invc);
+
     inline double
     get_input_arbiter_activity()
     {
@@ -91,12 +110,22 @@ class SwitchAllocator : public Consumer
     double m_input_arbiter_activity, m_output_arbiter_activity;
 
     Router *m_router;
+    SwitchAllocatorType m_sa_type;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
     std::vector<std::vector<bool>> m_port_requests;
+    // bitmask SA: one word per outport, a bit per requesting inport.
+    // Consumed (and so cleared) by SA-II every cycle.
+    std::vector<uint64_t> m_inport_requests;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
     std::vector<InputUnit *> m_input_unit;
     std::vector<OutputUnit *> m_output_unit;
+
+    // [inport * m_num_vcs + invc]: the head flit seen blocked, NULL if
+    // none, and the cycle it was first seen so. Updated by send_allowed.
+    void update_blocked(int inport, int invc, bool blocked);
+    std::vector<flit *> m_blocked_flit;
+    std::vector<Cycles> m_blocked_since;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_SWITCHALLOCATOR_HH__
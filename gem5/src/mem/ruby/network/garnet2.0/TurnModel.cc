@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+#include "mem/ruby/network/garnet2.0/TurnModel.hh"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include "base/logging.hh"
+
+TurnModel::TurnModel()
+    : m_num_routers(0)
+{
+    memset(m_prohibited, 0, sizeof(m_prohibited));
+}
+
+// parity 0: even columns, 1: odd columns, -1: all columns
+void
+TurnModel::prohibit(int parity, PortDirn from, PortDirn to)
+{
+    for (int p = 0; p < 2; p++) {
+        if (parity == -1 || parity == p)
+            m_prohibited[p][from] |= 1 << to;
+    }
+}
+
+static PortDirn
+travel_dirn(char c)
+{
+    switch (c) {
+        case 'N': return NORTH_DIRN_;
+        case 'E': return EAST_DIRN_;
+        case 'S': return SOUTH_DIRN_;
+        case 'W': return WEST_DIRN_;
+        default: return UNKNOWN_DIRN_;
+    }
+}
+
+void
+TurnModel::parseCustom(const std::vector<std::string> &custom_turns)
+{
+    for (int i = 0; i < custom_turns.size(); i++) {
+        std::string turn = custom_turns[i];
+        int parity = -1;
+        if (turn.compare(0, 5, "even:") == 0) {
+            parity = 0;
+            turn = turn.substr(5);
+        } else if (turn.compare(0, 4, "odd:") == 0) {
+            parity = 1;
+            turn = turn.substr(4);
+        }
+
+        PortDirn from = UNKNOWN_DIRN_, to = UNKNOWN_DIRN_;
+        if (turn.size() == 2) {
+            from = travel_dirn(turn[0]);
+            to = travel_dirn(turn[1]);
+        }
+        if (from == UNKNOWN_DIRN_ || to == UNKNOWN_DIRN_ || from == to)
+            fatal("Bad turn '%s' in the custom turn model; expected e.g. "
+                  "NW or odd:SW\n", custom_turns[i]);
+
+        prohibit(parity, from, to);
+    }
+}
+
+void
+TurnModel::init(const std::string &model,
+                const std::vector<std::string> &custom_turns,
+                const std::vector<RouterCoord> &coords,
+                int num_rows, int num_cols)
+{
+    if (model == "west_first") {
+        prohibit(-1, NORTH_DIRN_, WEST_DIRN_);
+        prohibit(-1, SOUTH_DIRN_, WEST_DIRN_);
+    } else if (model == "north_last") {
+        prohibit(-1, NORTH_DIRN_, EAST_DIRN_);
+        prohibit(-1, NORTH_DIRN_, WEST_DIRN_);
+    } else if (model == "negative_first") {
+        prohibit(-1, NORTH_DIRN_, WEST_DIRN_);
+        prohibit(-1, EAST_DIRN_, SOUTH_DIRN_);
+    } else if (model == "odd_even") {
+        prohibit(0, EAST_DIRN_, NORTH_DIRN_);
+        prohibit(0, EAST_DIRN_, SOUTH_DIRN_);
+        prohibit(1, NORTH_DIRN_, WEST_DIRN_);
+        prohibit(1, SOUTH_DIRN_, WEST_DIRN_);
+    } else if (model == "custom") {
+        parseCustom(custom_turns);
+    } else {
+        fatal("Unknown turn model %s\n", model);
+    }
+
+    m_num_routers = coords.size();
+    const int num_in = NUM_MESH_DIRN_;
+
+    std::vector<int> grid(num_rows * num_cols, -1);
+    for (int router = 0; router < m_num_routers; router++)
+        grid[coords[router].y * num_cols + coords[router].x] = router;
+
+    m_allowed.assign(m_num_routers * m_num_routers * num_in, 0);
+
+    // For each destination, fill in the routers nearest to it first:
+    // a minimal hop always lands one hop closer, on a router whose
+    // entries are already known.
+    std::vector<std::vector<int> > by_hops(num_rows + num_cols);
+    for (int dest = 0; dest < m_num_routers; dest++) {
+        const RouterCoord &d = coords[dest];
+
+        for (int hops = 0; hops < by_hops.size(); hops++)
+            by_hops[hops].clear();
+        for (int router = 0; router < m_num_routers; router++) {
+            const RouterCoord &r = coords[router];
+            by_hops[abs(d.x - r.x) + abs(d.y - r.y)].push_back(router);
+        }
+
+        for (int hops = 1; hops < by_hops.size(); hops++) {
+            for (int i = 0; i < by_hops[hops].size(); i++) {
+                int router = by_hops[hops][i];
+                const RouterCoord &r = coords[router];
+                int parity = r.x % 2;
+
+                PortDirn outs[2];
+                int num_outs = 0;
+                if (d.x != r.x)
+                    outs[num_outs++] = (d.x > r.x) ? EAST_DIRN_ : WEST_DIRN_;
+                if (d.y != r.y)
+                    outs[num_outs++] =
+                        (d.y > r.y) ? NORTH_DIRN_ : SOUTH_DIRN_;
+
+                uint8_t *row = &m_allowed[(router * m_num_routers + dest) *
+                                          num_in];
+                for (int in = LOCAL_DIRN_; in < num_in; in++) {
+                    uint8_t mask = 0;
+                    for (int o = 0; o < num_outs; o++) {
+                        PortDirn out = outs[o];
+                        if (in != LOCAL_DIRN_ &&
+                            (m_prohibited[parity][in] & (1 << out)))
+                            continue;
+
+                        int x = r.x + (out == EAST_DIRN_) -
+                                (out == WEST_DIRN_);
+                        int y = r.y + (out == NORTH_DIRN_) -
+                                (out == SOUTH_DIRN_);
+                        int next = grid[y * num_cols + x];
+                        assert(next != -1);
+
+                        if (next == dest ||
+                            m_allowed[(next * m_num_routers + dest) *
+                                      num_in + out] != 0)
+                            mask |= 1 << out;
+                    }
+                    row[in] = mask;
+                }
+
+                if (row[LOCAL_DIRN_] == 0)
+                    fatal("Turn model %s cannot route from router %d to "
+                          "router %d\n", model, router, dest);
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_TURNMODEL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_TURNMODEL_HH__
+
+#include <string>
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+
+// Turn model routing on a mesh, driven by a table of prohibited turns.
+// A turn is a change of travel direction (North, East, South, West) at
+// a router; it may be prohibited in all columns or only in the even or
+// odd ones (odd-even). init() works out, for every router, destination
+// and incoming travel direction, which minimal outports keep the
+// destination reachable without a prohibited turn, so routing is one
+// lookup per hop.
+class TurnModel
+{
+  public:
+    TurnModel();
+
+    // model: west_first, north_last, negative_first, odd_even or custom.
+    // custom_turns lists the prohibited turns of the custom model as
+    // "<from><to>" travel directions, e.g. "NW" for North to West,
+    // optionally prefixed by "even:" or "odd:" to restrict it to those
+    // columns. fatal() if some destination cannot be reached.
+    void init(const std::string &model,
+              const std::vector<std::string> &custom_turns,
+              const std::vector<RouterCoord> &coords,
+              int num_rows, int num_cols);
+
+    bool isValid() const { return !m_allowed.empty(); }
+
+    // Allowed outports of 'router' towards 'dest', one bit per PortDirn,
+    // for a flit travelling 'in' (a mesh PortDirn) or just injected
+    // (LOCAL_DIRN_). Rows are laid out [router][dest][in].
+    inline const uint8_t *
+    routerRow(int router) const
+    {
+        return &m_allowed[router * m_num_routers * NUM_MESH_DIRN_];
+    }
+
+  private:
+    void prohibit(int parity, PortDirn from, PortDirn to);
+    void parseCustom(const std::vector<std::string> &custom_turns);
+
+    int m_num_routers;
+
+    // m_prohibited[column parity][from] has bit 'to' set for every
+    // prohibited turn
+    uint8_t m_prohibited[2][NUM_MESH_DIRN_];
+
+    std::vector<uint8_t> m_allowed;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_TURNMODEL_HH__
@@ -37,7 +37,7 @@ VirtualChannel::VirtualChannel(int id)
     : m_enqueue_time(INFINITE_)
 {
     m_id = id;
-    m_input_buffer = new flitBuffer();
+    m_input_buffer = new flitBuffer(FIFO_ORDER_);
     m_vc_state.first = IDLE_;
     m_vc_state.second = Cycles(0);
     m_output_vc = -1;
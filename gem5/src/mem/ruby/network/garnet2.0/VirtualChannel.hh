@@ -57,6 +57,7 @@ class VirtualChannel
     inline void set_enqueue_time(Cycles time) { m_enqueue_time = time; }
     inline VC_state_type get_state()        { return m_vc_state.first; }
     inline bool isEmpty()                   { return m_input_buffer->isEmpty(); }
+    inline int getSize()                    { return m_input_buffer->getSize(); }
 
     inline bool isReady(Cycles curTime)
     {
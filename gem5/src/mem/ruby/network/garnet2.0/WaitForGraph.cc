@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#include "mem/ruby/network/garnet2.0/WaitForGraph.hh"
+
+#include <sstream>
+
+#include "base/logging.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
+#include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
+
+WaitForGraph::WaitForGraph(GarnetNetwork *net_ptr, uint32_t period,
+                           uint32_t threshold, bool rotation,
+                           uint32_t rotation_latency)
+    : Consumer(net_ptr), m_net_ptr(net_ptr), m_period(period),
+      m_threshold(threshold), m_rotation(rotation),
+      m_rotation_latency(rotation_latency), m_num_vcs(0),
+      m_vcs_per_vnet(0), m_deadlock_since(0)
+{
+    assert(period > 0);
+    if (rotation && rotation_latency == 0)
+        fatal("Deadlock rotation takes at least a cycle\n");
+}
+
+void
+WaitForGraph::init()
+{
+    int num_routers = m_net_ptr->getNumRouters();
+    m_vcs_per_vnet = m_net_ptr->getVCsPerVnet();
+    m_node_base.resize(num_routers);
+    m_node_router.clear();
+    for (int router = 0; router < num_routers; router++) {
+        Router *router_ptr = m_net_ptr->getRouter(router);
+        m_num_vcs = router_ptr->get_num_vcs();
+        m_node_base[router] = m_node_router.size();
+        m_node_router.resize(m_node_router.size() +
+                             router_ptr->get_num_inports() * m_num_vcs,
+                             router);
+    }
+
+    int num_nodes = m_node_router.size();
+    m_waits_on.assign(num_nodes, -1);
+    m_waiting_pos.assign(num_nodes, -1);
+    m_deadlocked.assign(num_nodes, false);
+    m_visit.assign(num_nodes, -1);
+
+    scheduleEvent(Cycles(m_period));
+}
+
+void
+WaitForGraph::block(int router, int inport, int vc, int outport)
+{
+    int node = nodeId(router, inport, vc);
+    OutputUnit *output_unit =
+        m_net_ptr->getRouter(router)->get_outputUnit_ref()[outport];
+    int downstream = output_unit->get_downstream_router();
+    if (downstream == -1) {
+        // waits for an NI, which always drains
+        unblock(router, inport, vc);
+        return;
+    }
+
+    int vnet = vc / m_vcs_per_vnet;
+    m_waits_on[node] = nodeId(downstream,
+                              output_unit->get_downstream_inport(),
+                              vnet * m_vcs_per_vnet);
+    if (m_waiting_pos[node] == -1) {
+        m_waiting_pos[node] = m_waiting.size();
+        m_waiting.push_back(node);
+    }
+}
+
+void
+WaitForGraph::unblock(int router, int inport, int vc)
+{
+    int node = nodeId(router, inport, vc);
+    int pos = m_waiting_pos[node];
+    if (pos == -1)
+        return;
+
+    m_waits_on[node] = -1;
+    m_waiting_pos[node] = -1;
+    int last = m_waiting.back();
+    m_waiting.pop_back();
+    if (last != node) {
+        m_waiting[pos] = last;
+        m_waiting_pos[last] = pos;
+    }
+}
+
+// Edges are only dropped when the SwitchAllocator sees the VC again;
+// a flit may have left it another way since, e.g. by a swap.
+bool
+WaitForGraph::isStillBlocked(int node)
+{
+    Router *router_ptr = m_net_ptr->getRouter(m_node_router[node]);
+    return router_ptr->get_switchAllocator_ref()->is_blocked(
+        nodeInport(node), nodeVC(node));
+}
+
+// Leaves the deadlocked nodes in m_candidates, flagged in m_deadlocked.
+// Starts from every blocked node and peels off those waiting on a VC
+// that is not blocked itself, until none is left to peel.
+void
+WaitForGraph::findDeadlock()
+{
+    m_candidates.clear();
+    for (int i = m_waiting.size() - 1; i >= 0; i--) {
+        int node = m_waiting[i];
+        if (!isStillBlocked(node)) {
+            unblock(m_node_router[node], nodeInport(node), nodeVC(node));
+            continue;
+        }
+        m_deadlocked[node] = true;
+        m_candidates.push_back(node);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < m_candidates.size(); ) {
+            int node = m_candidates[i];
+            int first = m_waits_on[node];
+            bool stuck = true;
+            for (int vc = 0; vc < m_vcs_per_vnet; vc++) {
+                if (!m_deadlocked[first + vc]) {
+                    stuck = false;
+                    break;
+                }
+            }
+            if (stuck) {
+                i++;
+                continue;
+            }
+            m_deadlocked[node] = false;
+            m_candidates[i] = m_candidates.back();
+            m_candidates.pop_back();
+            changed = true;
+        }
+    }
+}
+
+// A deadlocked node waits only on deadlocked nodes, so following any
+// of its edges from one of them must come back around.
+void
+WaitForGraph::findRing()
+{
+    std::vector<int> path;
+    int node = m_candidates[0];
+    while (m_visit[node] == -1) {
+        m_visit[node] = path.size();
+        path.push_back(node);
+        node = m_waits_on[node];
+        assert(m_deadlocked[node]);
+    }
+
+    m_ring.assign(path.begin() + m_visit[node], path.end());
+    for (int i = 0; i < path.size(); i++)
+        m_visit[path[i]] = -1;
+}
+
+void
+WaitForGraph::trace()
+{
+    DPRINTF(RubyNetwork, "Deadlock of %d VCs at cycle %lld, "
+            "one cycle of %d:\n", m_candidates.size(),
+            m_net_ptr->curCycle(), m_ring.size());
+    for (int i = 0; i < m_ring.size(); i++) {
+        int node = m_ring[i];
+        Router *router_ptr = m_net_ptr->getRouter(m_node_router[node]);
+        int inport = nodeInport(node);
+        int vc = nodeVC(node);
+        std::ostringstream t_flit;
+        t_flit << *router_ptr->get_inputUnit_ref()[inport]->peekTopFlit(vc);
+        DPRINTF(RubyNetwork, "  Router %d inport %d (%s) vc %d: %s\n",
+                m_node_router[node], inport,
+                router_ptr->getInportDirection(inport), vc, t_flit.str());
+
+        #if (MY_PRINT)
+            cout << "Deadlock: router " << m_node_router[node]
+                 << " inport " << inport << " vc " << vc << " "
+                 << t_flit.str() << endl;
+        #endif
+    }
+}
+
+// A VC hands its only flit on and takes one whole packet in return, so
+// the VC and credit states, which are per packet, stay valid. With a
+// multi-flit packet, or a flit queued behind the head, they would not.
+bool
+WaitForGraph::can_rotate()
+{
+    for (int i = 0; i < m_ring.size(); i++) {
+        int node = m_ring[i];
+        Router *router_ptr = m_net_ptr->getRouter(m_node_router[node]);
+        InputUnit *input_unit =
+            router_ptr->get_inputUnit_ref()[nodeInport(node)];
+        if (input_unit->get_vc_size(nodeVC(node)) != 1 ||
+            input_unit->peekTopFlit(nodeVC(node))->get_type() != HEAD_TAIL_)
+            return false;
+    }
+    return true;
+}
+
+// Pop every head flit of the ring first, then put each in the VC it
+// waited on, as the head. A rotated flit is routed like a swapped one:
+// it makes one hop of forward progress, and nobody moves backwards.
+// VC and credit states are left alone: each VC gives and takes a flit.
+void
+WaitForGraph::rotate()
+{
+    if (!can_rotate()) {
+        DPRINTF(RubyNetwork, "Rotation of a ring of %d VCs skipped: not "
+                "all hold a single HEAD_TAIL_ flit\n", m_ring.size());
+        m_net_ptr->increment_skipped_rotations();
+        return;
+    }
+
+    int ring_length = m_ring.size();
+    std::vector<flit *> flits(ring_length);
+    for (int i = 0; i < ring_length; i++) {
+        int node = m_ring[i];
+        Router *router_ptr = m_net_ptr->getRouter(m_node_router[node]);
+        flits[i] = router_ptr->get_inputUnit_ref()[nodeInport(node)]->
+            getTopFlit(nodeVC(node));
+    }
+
+    Cycles ready = m_net_ptr->curCycle() + Cycles(m_rotation_latency);
+    for (int i = 0; i < ring_length; i++) {
+        int next = m_ring[(i + 1) % ring_length];
+        Router *router_ptr = m_net_ptr->getRouter(m_node_router[next]);
+        flits[i]->set_time(ready);
+        router_ptr->doSwap_enqueue(flits[i], nodeInport(next),
+                                   nodeVC(next), true);
+        // SA only looks a cycle ahead
+        router_ptr->schedule_wakeup(Cycles(m_rotation_latency));
+
+        DPRINTF(RubyNetwork, "Rotation moved flit %d from router %d to "
+                "router %d inport %d vc %d\n", flits[i]->get_id(),
+                m_node_router[m_ring[i]], m_node_router[next],
+                nodeInport(next), nodeVC(next));
+    }
+
+    m_net_ptr->increment_rotations(ring_length);
+}
+
+void
+WaitForGraph::wakeup()
+{
+    Cycles now = m_net_ptr->curCycle();
+    m_net_ptr->increment_deadlock_checks();
+
+    m_candidates.clear();
+    if (!m_waiting.empty())
+        findDeadlock();
+
+    if (m_candidates.empty()) {
+        if (!m_ring.empty())
+            m_net_ptr->increment_deadlock_recoveries(now - m_deadlock_since);
+        m_ring.clear();
+    } else {
+        bool is_new = m_ring.empty();
+        findRing();
+        if (is_new) {
+            m_deadlock_since = now;
+            m_net_ptr->increment_deadlocks(m_candidates.size(),
+                                           m_ring.size());
+            trace();
+            m_net_ptr->deadlockSnapshot();
+        } else {
+            m_net_ptr->increment_deadlocked_cycles(m_period);
+        }
+
+        for (int i = 0; i < m_candidates.size(); i++)
+            m_deadlocked[m_candidates[i]] = false;
+
+        // checked again after the next period
+        if (m_rotation)
+            rotate();
+
+        panic_if(m_threshold > 0 && now - m_deadlock_since > m_threshold,
+                 "Network deadlock of %d VCs unresolved since cycle %lld\n",
+                 m_candidates.size(), m_deadlock_since);
+    }
+
+    scheduleEvent(Cycles(m_period));
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_WAITFORGRAPH_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_WAITFORGRAPH_HH__
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+
+class GarnetNetwork;
+
+// Channel wait-for graph, for ground truth on deadlocks. A node is an
+// input VC of a router. The SwitchAllocator adds the edges of a head
+// flit that finds no free VC at its outport: it waits on every VC of its
+// vnet at the downstream inport. The edges are dropped when it gets one.
+//
+// Every 'period' cycles the graph is checked for a deadlock: a set of
+// blocked VCs all waiting only on VCs of the set, so none can drain.
+// Each new deadlock is counted and one of its cycles of VCs is traced.
+// A deadlock that persists for 'threshold' cycles ends the simulation.
+//
+// In rotation mode every check that finds a deadlock also resolves the
+// traced cycle in one operation: the head flit of each VC in it moves
+// one hop, into the VC it waits on. The moved flits are held for
+// 'rotation_latency' cycles, the modeled cost of the operation. Only a
+// cycle of single-flit packets, one per VC, can be rotated this way;
+// any other is skipped and counted.
+class WaitForGraph : public Consumer
+{
+  public:
+    WaitForGraph(GarnetNetwork *net_ptr, uint32_t period,
+                 uint32_t threshold, bool rotation,
+                 uint32_t rotation_latency);
+
+    // after the links are made; numbers the nodes, schedules the
+    // first check
+    void init();
+    void wakeup();
+    void print(std::ostream& out) const {};
+
+    // (router, inport, vc) waits for a VC behind 'outport' / got one
+    void block(int router, int inport, int vc, int outport);
+    void unblock(int router, int inport, int vc);
+
+    // the deadlock found by the last check: its cycle of VCs, in wait
+    // order, or empty if there was none
+    bool isDeadlocked() const { return !m_ring.empty(); }
+    const std::vector<int> &ring() const { return m_ring; }
+    Cycles deadlockedSince() const { return m_deadlock_since; }
+
+    inline int
+    nodeId(int router, int inport, int vc) const
+    {
+        return m_node_base[router] + inport * m_num_vcs + vc;
+    }
+    inline int nodeRouter(int node) const { return m_node_router[node]; }
+    inline int
+    nodeInport(int node) const
+    {
+        return (node - m_node_base[m_node_router[node]]) / m_num_vcs;
+    }
+    inline int
+    nodeVC(int node) const
+    {
+        return (node - m_node_base[m_node_router[node]]) % m_num_vcs;
+    }
+
+  private:
+    bool isStillBlocked(int node);
+    void findDeadlock();
+    void findRing();
+    void trace();
+    bool can_rotate();
+    void rotate();
+
+    GarnetNetwork *m_net_ptr;
+    uint32_t m_period;
+    uint32_t m_threshold;
+    bool m_rotation;
+    uint32_t m_rotation_latency;
+    int m_num_vcs;
+    int m_vcs_per_vnet;
+
+    // first node of each router, and the router of each node
+    std::vector<int> m_node_base;
+    std::vector<int> m_node_router;
+
+    // [node]: first VC of the group it waits on, -1 if it is not
+    // blocked. m_waiting lists the blocked nodes, m_waiting_pos their
+    // index in it.
+    std::vector<int> m_waits_on;
+    std::vector<int> m_waiting;
+    std::vector<int> m_waiting_pos;
+
+    // scratch of a check: the deadlocked nodes, and the order a walk
+    // visited them in
+    std::vector<bool> m_deadlocked;
+    std::vector<int> m_candidates;
+    std::vector<int> m_visit;
+
+    std::vector<int> m_ring;
+    Cycles m_deadlock_since;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_WAITFORGRAPH_HH__
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_CREDITBUFFER_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_CREDITBUFFER_HH__
+
+#include <iostream>
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/Credit.hh"
+
+// FIFO of credits used on the credit return path (InputUnit/NI ->
+// CreditLink -> OutputUnit/NI). Credits are always inserted in
+// nondecreasing time order, so a ring is enough; no heap ordering and
+// no per-credit allocation. The ring only grows if it ever fills up.
+class creditBuffer
+{
+  public:
+    creditBuffer(int capacity = 4);
+
+    bool isEmpty() const { return (m_size == 0); }
+    int getSize() const { return m_size; }
+    void print(std::ostream& out) const;
+
+    bool
+    isReady(Cycles curTime) const
+    {
+        return ((m_size != 0) && (m_ring[m_head].get_time() <= curTime));
+    }
+
+    const Credit &
+    peekTopCredit() const
+    {
+        assert(m_size > 0);
+        return m_ring[m_head];
+    }
+
+    Credit
+    getTopCredit()
+    {
+        assert(m_size > 0);
+        Credit credit = m_ring[m_head];
+        m_head = (m_head + 1) % m_ring.size();
+        m_size--;
+        return credit;
+    }
+
+    void
+    insert(const Credit &credit)
+    {
+        if (m_size == m_ring.size())
+            grow();
+        int tail = (m_head + m_size) % m_ring.size();
+        // time order is what makes the FIFO equivalent to the old heap
+        assert((m_size == 0) ||
+               (m_ring[(tail + m_ring.size() - 1) % m_ring.size()]
+                    .get_time() <= credit.get_time()));
+        m_ring[tail] = credit;
+        m_size++;
+    }
+
+  private:
+    void grow();
+
+    std::vector<Credit> m_ring;
+    int m_head;
+    int m_size;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const creditBuffer& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_CREDITBUFFER_HH__
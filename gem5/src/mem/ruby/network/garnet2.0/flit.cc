@@ -34,7 +34,7 @@
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
 // Constructor for the flit
-flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
+flit::flit(int id, int  vc, int vnet, const RouteInfo &route, int size,
     MsgPtr msg_ptr, Cycles curTime)
 {
     m_size = size;
@@ -48,6 +48,7 @@ flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
     m_route = route;
     m_stage.first = I_;
     m_stage.second = m_time;
+    m_outport_dir = UNKNOWN_DIRN_;
 
     if (size == 1) {
         m_type = HEAD_TAIL_;
@@ -101,12 +102,12 @@ flit::functionalWrite(Packet *pkt)
 
 //SWAP_GARNET_2.0_MERGE
 void
-flit::set_outport_dir(PortDirection dir)
+flit::set_outport_dir(PortDirn dir)
 {
 	m_outport_dir = dir;
 }
 
-PortDirection
+PortDirn
 flit::get_outport_dir()
 {
 	return m_outport_dir;
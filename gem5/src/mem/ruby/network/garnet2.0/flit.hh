@@ -41,13 +41,11 @@
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
-typedef std::string PortDirection;
-
 class flit
 {
   public:
     flit() {}
-    flit(int id, int vc, int vnet, RouteInfo route, int size,
+    flit(int id, int vc, int vnet, const RouteInfo &route, int size,
          MsgPtr msg_ptr, Cycles curTime);
 
     int get_outport() {return m_outport; }
@@ -55,7 +53,7 @@ class flit
     void set_RoutedSwap() { routedSwap = true; }
     void unset_RoutedSwap() { routedSwap = false; }
     bool get_RoutedSwap() { return routedSwap; }
-	PortDirection get_outport_dir();
+	PortDirn get_outport_dir();
     int get_size() { return m_size; }
     Cycles get_enqueue_time() { return m_enqueue_time; }
     Cycles get_dequeue_time() { return m_dequeue_time; }
@@ -63,21 +61,41 @@ class flit
     Cycles get_time() { return m_time; }
     int get_vnet() { return m_vnet; }
     int get_vc() { return m_vc; }
-    RouteInfo get_route() { return m_route; }
+    const RouteInfo &get_route() const { return m_route; }
     MsgPtr& get_msg_ptr() { return m_msg_ptr; }
     flit_type get_type() { return m_type; }
     std::pair<flit_stage, Cycles> get_stage() { return m_stage; }
     Cycles get_src_delay() { return src_delay; }
 
     void set_outport(int port) { m_outport = port; }
-    void set_outport_dir(PortDirection dir);
+    void set_outport_dir(PortDirn dir);
     void set_time(Cycles time) { m_time = time; }
     void set_vc(int vc) { m_vc = vc; }
-    void set_route(RouteInfo route) { m_route = route; }
+    void set_route(const RouteInfo &route) { m_route = route; }
     void set_src_delay(Cycles delay) { src_delay = delay; }
     void set_dequeue_time(Cycles time) { m_dequeue_time = time; }
 
     void increment_hops() { m_route.hops_traversed++; }
+    // move the source route cursor with the flit, see RouteInfo
+    void
+    advance_path()
+    {
+        if (m_route.path_id != -1)
+            m_route.path_hop++;
+    }
+    void
+    retreat_path()
+    {
+        if (m_route.path_id != -1)
+            m_route.path_hop--;
+    }
+    // start the second phase on reaching the intermediate router
+    void
+    reach_router(int router)
+    {
+        if (m_route.intermediate == router)
+            m_route.intermediate_reached = true;
+    }
     void print(std::ostream& out) const;
 
     bool
@@ -121,7 +139,7 @@ class flit
     flit_type m_type;
     MsgPtr m_msg_ptr;
     int m_outport;
-    PortDirection m_outport_dir;
+    PortDirn m_outport_dir;
     Cycles src_delay;
     std::pair<flit_stage, Cycles> m_stage;
 };
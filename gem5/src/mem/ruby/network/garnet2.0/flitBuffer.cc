@@ -34,25 +34,47 @@
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 
 flitBuffer::flitBuffer()
+    : m_order(TIME_ORDER_), m_ring_head(0), m_ring_size(0)
 {
     max_size = INFINITE_;
 }
 
 flitBuffer::flitBuffer(int maximum_size)
+    : m_order(TIME_ORDER_), m_ring_head(0), m_ring_size(0)
 {
     max_size = maximum_size;
 }
 
+flitBuffer::flitBuffer(flitBuffer_order order, int maximum_size)
+    : m_order(order), m_ring_head(0), m_ring_size(0)
+{
+    max_size = maximum_size;
+    if (m_order == FIFO_ORDER_)
+        m_buffer.resize(4);
+}
+
+// Double the ring, unwrapping the buffered flits to the front
+void
+flitBuffer::grow()
+{
+    assert(m_order == FIFO_ORDER_);
+    std::vector<flit *> ring(2 * m_buffer.size());
+    for (int i = 0; i < m_ring_size; i++)
+        ring[i] = ringAt(i);
+    m_buffer.swap(ring);
+    m_ring_head = 0;
+}
+
 bool
 flitBuffer::isEmpty()
 {
-    return (m_buffer.size() == 0);
+    return (getSize() == 0);
 }
 
 bool
 flitBuffer::isReady(Cycles curTime)
 {
-    if (m_buffer.size() != 0 ) {
+    if (getSize() != 0 ) {
         flit *t_flit = peekTopFlit();
         if (t_flit->get_time() <= curTime)
             return true;
@@ -63,13 +85,13 @@ flitBuffer::isReady(Cycles curTime)
 void
 flitBuffer::print(std::ostream& out) const
 {
-    out << "[flitBuffer: " << m_buffer.size() << "] " << std::endl;
+    out << "[flitBuffer: " << getSize() << "] " << std::endl;
 }
 
 bool
 flitBuffer::isFull()
 {
-    return (m_buffer.size() >= max_size);
+    return (getSize() >= max_size);
 }
 
 void
@@ -83,8 +105,8 @@ flitBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    for (unsigned int i = 0; i < m_buffer.size(); ++i) {
-        if (m_buffer[i]->functionalWrite(pkt)) {
+    for (int i = 0; i < getSize(); ++i) {
+        if (flitAt(i)->functionalWrite(pkt)) {
             num_functional_writes++;
         }
     }
@@ -42,22 +42,42 @@
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
 using namespace std;
+
+// TIME_ORDER_ buffers keep a binary heap on flit::greater, for queues
+// whose producers may insert out of time order. FIFO_ORDER_ buffers are
+// a ring, for queues that only ever receive flits in nondecreasing time
+// order (links, input VCs, output and NI queues); they are O(1) and
+// support pushing a swapped flit at the head.
+enum flitBuffer_order { TIME_ORDER_, FIFO_ORDER_ };
+
 class flitBuffer
 {
   public:
     flitBuffer();
     flitBuffer(int maximum_size);
+    flitBuffer(flitBuffer_order order, int maximum_size = INFINITE_);
 
     bool isReady(Cycles curTime);
     bool isEmpty();
     void print(std::ostream& out) const;
     bool isFull();
     void setMaxSize(int maximum);
-    int getSize() const { return m_buffer.size(); }
+    int
+    getSize() const
+    {
+        return (m_order == FIFO_ORDER_) ? m_ring_size : m_buffer.size();
+    }
 
     flit *
     getTopFlit()
     {
+        if (m_order == FIFO_ORDER_) {
+            assert(m_ring_size > 0);
+            flit *f = m_buffer[m_ring_head];
+            m_ring_head = (m_ring_head + 1) % m_buffer.size();
+            m_ring_size--;
+            return f;
+        }
         flit *f = m_buffer.front();
         std::pop_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
         m_buffer.pop_back();
@@ -71,6 +91,10 @@ class flitBuffer
         // making the safety check here
         // because front() on empty container
         // causes undefined behavior.
+        if (m_order == FIFO_ORDER_) {
+            assert(m_ring_size > 0);
+            return m_buffer[m_ring_head];
+        }
         assert(m_buffer.size() > 0);
         return m_buffer.front();
     }
@@ -78,30 +102,67 @@ class flitBuffer
     void
     insert(flit *flt)
     {
+        if (m_order == FIFO_ORDER_) {
+            if (m_ring_size == m_buffer.size())
+                grow();
+            // FIFO order is only equivalent to time order if the
+            // producer never goes back in time
+            assert((m_ring_size == 0) ||
+                   (ringAt(m_ring_size - 1)->get_time() <= flt->get_time()));
+            m_buffer[(m_ring_head + m_ring_size) % m_buffer.size()] = flt;
+            m_ring_size++;
+            return;
+        }
         m_buffer.push_back(flt);
         std::push_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
     }
     //SWAP_GARNET_2.0_MERGE
+    // Put a swapped flit at the head, ahead of whatever is buffered.
+    // Only FIFO buffers can do this; the heap would have to reorder it.
     void
     insertAtTop(flit *flt)
     {
-        m_buffer.insert(m_buffer.begin(), flt);
+        assert(m_order == FIFO_ORDER_);
+        if (m_ring_size == m_buffer.size())
+            grow();
+        m_ring_head = (m_ring_head + m_buffer.size() - 1) % m_buffer.size();
+        m_buffer[m_ring_head] = flt;
+        m_ring_size++;
     }
 
     void
     scan()
     {
-        for (std::vector<flit *>::iterator itr = m_buffer.begin(); itr != m_buffer.end(); ++itr)
+        for (int i = 0; i < getSize(); i++)
         {
-            cout << **itr << endl;
+            cout << *flitAt(i) << endl;
         }
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
+    // i-th buffered flit, in storage order (heap) or queue order (FIFO)
+    flit *
+    flitAt(int i) const
+    {
+        return (m_order == FIFO_ORDER_) ? ringAt(i) : m_buffer[i];
+    }
+
+    flit *
+    ringAt(int i) const
+    {
+        return m_buffer[(m_ring_head + i) % m_buffer.size()];
+    }
+
+    void grow();
+
+    // heap storage, or the ring slots in FIFO mode
     std::vector<flit *> m_buffer;
     int max_size;
+    flitBuffer_order m_order;
+    int m_ring_head;
+    int m_ring_size;
 };
 
 inline std::ostream&
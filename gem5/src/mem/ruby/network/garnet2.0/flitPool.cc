@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#include "mem/ruby/network/garnet2.0/flitPool.hh"
+
+#include <new>
+
+flitPool::flitPool(int slab_size)
+    : m_slab_size(slab_size), m_live(0), m_peak_live(0)
+{
+    assert(m_slab_size > 0);
+}
+
+flitPool::~flitPool()
+{
+    // Flits still sitting in buffers at the end of simulation live in
+    // the slabs; they are not destructed individually.
+    for (int i = 0; i < m_slabs.size(); i++)
+        ::operator delete(m_slabs[i]);
+}
+
+// Carve a new slab into flit-sized slots and put them on the free list
+void
+flitPool::grow()
+{
+    void *slab = ::operator new(m_slab_size * sizeof(flit));
+    m_slabs.push_back(slab);
+
+    flit *slots = static_cast<flit *>(slab);
+    m_free_list.reserve(m_slabs.size() * m_slab_size);
+    for (int i = m_slab_size - 1; i >= 0; i--)
+        m_free_list.push_back(&slots[i]);
+}
+
+flit *
+flitPool::allocate(int id, int vc, int vnet, const RouteInfo &route, int size,
+                   MsgPtr msg_ptr, Cycles curTime)
+{
+    if (m_free_list.empty())
+        grow();
+
+    flit *slot = m_free_list.back();
+    m_free_list.pop_back();
+
+    m_live++;
+    if (m_live > m_peak_live)
+        m_peak_live = m_live;
+
+    return new (slot) flit(id, vc, vnet, route, size, msg_ptr, curTime);
+}
+
+void
+flitPool::release(flit *t_flit)
+{
+    assert(m_live > 0);
+    // drops the message reference held by the flit
+    t_flit->~flit();
+    m_free_list.push_back(t_flit);
+    m_live--;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2008 Princeton University
+ * Copyright (c) 2016 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Authors: Niket Agarwal
+ *          Tushar Krishna
+ */
+
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_FLITPOOL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_FLITPOOL_HH__
+
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/flit.hh"
+
+// Slab allocator for flits. The NIs allocate a flit per injected
+// packet and release it at ejection; flits are recycled through a
+// free list, so once the pool has grown to the peak number of flits
+// in flight, injection and ejection do not touch the heap.
+class flitPool
+{
+  public:
+    flitPool(int slab_size = 1024);
+    ~flitPool();
+
+    flit *allocate(int id, int vc, int vnet, const RouteInfo &route, int size,
+                   MsgPtr msg_ptr, Cycles curTime);
+    void release(flit *t_flit);
+
+    int get_live() const { return m_live; }
+    int get_peak_live() const { return m_peak_live; }
+    int get_num_slabs() const { return m_slabs.size(); }
+
+  private:
+    void grow();
+
+    int m_slab_size;
+    std::vector<void *> m_slabs;
+    std::vector<flit *> m_free_list;
+    int m_live;
+    int m_peak_live;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_FLITPOOL_HH__